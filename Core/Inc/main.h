@@ -123,6 +123,7 @@ typedef struct
 #define SX1262_DIO1_EXTI_IRQn EXTI2_3_IRQn
 #define SX1262_BUSY_Pin GPIO_PIN_10
 #define SX1262_BUSY_GPIO_Port GPIOB
+#define SX1262_BUSY_EXTI_IRQn EXTI4_15_IRQn
 #define LED_GREEN_Pin GPIO_PIN_15
 #define LED_GREEN_GPIO_Port GPIOB
 #define SX1262_RF_SW_Pin GPIO_PIN_12
@@ -158,6 +159,7 @@ typedef struct
 #define CMD_MAIN_IWDG_REFRESH		      250   // Start heartbeat collection
 #define CMD_MAIN_HB_RESPONSE_RF       249   // RF task heartbeat response
 #define CMD_MAIN_RF_TX_DONE           248
+#define CMD_MAIN_AT_UART_ERROR        247   // UART error reported from ISR
 
 #define CMD_RF_TURN_ON			    254
 #define CMD_RF_TURN_OFF			    253
@@ -169,6 +171,12 @@ typedef struct
 #define CMD_RF_RADIO_RECONFIG_RX 247
 #define CMD_RF_HB_REQUEST       246   // Heartbeat request from main task
 #define CMD_RF_TX_CW            245   // Start/Stop TX CW mode
+#define CMD_RF_RADIO_CFG_DIRTY  244   // LoRa parametry v NVM zmeneny, data = RU_CFG_DIRTY_TX/RX
+#define CMD_RF_LBT_RETRY        243   // LBT backoff vyprsel, zopakovat CAD
+#define CMD_RF_SEND_DATA_LR_FHSS 242  // vysilani paketu LR-FHSS modulaci
+#define CMD_RF_SEND_DATA_SCHED  241   // vysilani paketu v case packet_info_t.sched_us
+#define CMD_RF_SCHED_FIRE       240   // cas naplanovaneho TX nastal, SPI bylo v ISR obsazene
+#define CMD_RF_SCHED_PRELOAD    239   // blizi se cas naplanovaneho TX, nahrat payload do SX126x
 
 
 
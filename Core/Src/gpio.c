@@ -112,7 +112,7 @@ void MX_GPIO_Init(void)
 
   /*Configure GPIO pin : SX1262_BUSY_Pin */
   GPIO_InitStruct.Pin = SX1262_BUSY_Pin;
-  GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
+  GPIO_InitStruct.Mode = GPIO_MODE_IT_FALLING;
   GPIO_InitStruct.Pull = GPIO_NOPULL;
   HAL_GPIO_Init(SX1262_BUSY_GPIO_Port, &GPIO_InitStruct);
 
@@ -120,8 +120,23 @@ void MX_GPIO_Init(void)
   HAL_NVIC_SetPriority(EXTI2_3_IRQn, 3, 0);
   HAL_NVIC_EnableIRQ(EXTI2_3_IRQn);
 
+  HAL_NVIC_SetPriority(EXTI4_15_IRQn, 3, 0);
+  HAL_NVIC_EnableIRQ(EXTI4_15_IRQn);
+
 }
 
 /* USER CODE BEGIN 2 */
 
+/**
+ * @brief Mask SX1262 BUSY EXTI line after MX_GPIO_Init
+ *
+ * HAL_GPIO_Init unmasks the line, sx126x_hal_wait_on_busy enables it only
+ * while a task blocks on BUSY.
+ */
+void GPIO_MaskBusyExti(void)
+{
+  CLEAR_BIT(EXTI->IMR, SX1262_BUSY_Pin);
+  __HAL_GPIO_EXTI_CLEAR_IT(SX1262_BUSY_Pin);
+}
+
 /* USER CODE END 2 */
@@ -22,6 +22,7 @@
 #include "dma.h"
 #include "iwdg.h"
 #include "spi.h"
+#include "tim.h"
 #include "usart.h"
 #include "gpio.h"
 
@@ -30,6 +31,7 @@
 #include "AT_cmd.h"
 #include "cmsis_os2.h"
 #include "hw_config.h"
+#include "sx126x_hal.h"
 
 extern osMessageQueueId_t queueRadioHandle;
 
@@ -70,15 +72,27 @@ void MX_FREERTOS_Init(void);
 
 
 /**
- * @brief 
+ * @brief UART RX event (HT/TC/IDLE of circular DMA) - only hands the ring
+ *        position over to the main task, parsing and dispatch run in task context
  * 
  * @param huart 
- * @param Size 
+ * @param Size current DMA write position in the Rx ring
  */
 void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
 { 
     UNUSED(huart);
-    AT_HandleATCommand(Size);
+    AT_RxEventFromISR(Size);
+}
+
+/**
+ * @brief DMA Tx chunk sent - continue with the rest of Tx ring
+ * 
+ * @param huart 
+ */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{ 
+    UNUSED(huart);
+    AT_TxCompleteFromISR();
 }
 
 /**
@@ -90,7 +104,7 @@ void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
 void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
 { 
     UNUSED(huart);
-    AT_HandleUartError();
+    AT_UartErrorFromISR();
 }
 
 
@@ -98,14 +112,22 @@ void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
 { 
   dataQueue_t txm;
 	txm.ptr = NULL;
-  BaseType_t xHigherPriorityTaskWoken;
+  BaseType_t xHigherPriorityTaskWoken = pdFALSE;
 
 
   if(GPIO_Pin == SX1262_DIO1_Pin)
   {
       txm.cmd = CMD_RF_IRQ_FIRED;
+      txm.tmp_32 = TIM_GetTimestampUs();  // cas udalosti (RX/TX done) bez zpozdeni fronty
 
-      xQueueSendFromISR(queueRadioHandle,&txm,&xHigherPriorityTaskWoken );
+      // IRQ predbiha prikazy ve fronte - LR-FHSS hop se musi doplnit pred dalsim hopem
+      xQueueSendToFrontFromISR(queueRadioHandle,&txm,&xHigherPriorityTaskWoken );
+  }
+
+  if(GPIO_Pin == SX1262_BUSY_Pin)
+  {
+      // BUSY falling edge - probudi task blokovany v sx126x_hal_wait_on_busy
+      sx126x_hal_busy_irq_from_isr(GPIO_Pin);
   }
 
   if( xHigherPriorityTaskWoken )
@@ -167,8 +189,11 @@ int main(void)
   MX_USART1_UART_Init();
   MX_SPI1_Init();
   MX_IWDG_Init();
+  MX_TIM2_Init();
   /* USER CODE BEGIN 2 */
 
+  // BUSY EXTI jen behem cekani na SX126x (sx126x_hal_wait_on_busy)
+  GPIO_MaskBusyExti();
   LOG_Initialise();
   PrintAppInfo();
 
@@ -0,0 +1,276 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file    tim.c
+  * @brief   This file provides code for the configuration
+  *          of the TIM instances.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Includes ------------------------------------------------------------------*/
+#include "tim.h"
+
+/* USER CODE BEGIN 0 */
+// TIM2 je na L0 jen 16 bitovy - horni polovina casu se pocita v update IRQ
+static volatile uint16_t tim2Overflows = 0;
+
+// Naplanovana udalost - CC1 se povoli az kdyz je cil mene nez jedno preteceni daleko
+static volatile uint32_t timSchedTarget;
+static void (*volatile timSchedCallback)(void) = NULL;
+static volatile bool timSchedCompare = false;
+
+static void TIM_ScheduleCheck(void);
+/* USER CODE END 0 */
+
+TIM_HandleTypeDef htim2;
+
+/* TIM2 init function */
+void MX_TIM2_Init(void)
+{
+
+  /* USER CODE BEGIN TIM2_Init 0 */
+
+  /* USER CODE END TIM2_Init 0 */
+
+  TIM_ClockConfigTypeDef sClockSourceConfig = {0};
+  TIM_MasterConfigTypeDef sMasterConfig = {0};
+  TIM_OC_InitTypeDef sConfigOC = {0};
+
+  /* USER CODE BEGIN TIM2_Init 1 */
+
+  /* USER CODE END TIM2_Init 1 */
+  htim2.Instance = TIM2;
+  htim2.Init.Prescaler = 31;
+  htim2.Init.CounterMode = TIM_COUNTERMODE_UP;
+  htim2.Init.Period = 65535;
+  htim2.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+  htim2.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+  if (HAL_TIM_Base_Init(&htim2) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  sClockSourceConfig.ClockSource = TIM_CLOCKSOURCE_INTERNAL;
+  if (HAL_TIM_ConfigClockSource(&htim2, &sClockSourceConfig) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  sMasterConfig.MasterOutputTrigger = TIM_TRGO_RESET;
+  sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
+  if (HAL_TIM_OC_Init(&htim2) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  if (HAL_TIMEx_MasterConfigSynchronization(&htim2, &sMasterConfig) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  sConfigOC.OCMode = TIM_OCMODE_TIMING;
+  sConfigOC.Pulse = 0;
+  sConfigOC.OCPolarity = TIM_OCPOLARITY_HIGH;
+  sConfigOC.OCFastMode = TIM_OCFAST_DISABLE;
+  if (HAL_TIM_OC_ConfigChannel(&htim2, &sConfigOC, TIM_CHANNEL_1) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  /* USER CODE BEGIN TIM2_Init 2 */
+  // 1 MHz pri HCLK 32 MHz, prescaler podle skutecne frekvence
+  __HAL_TIM_SET_PRESCALER(&htim2, (HAL_RCC_GetPCLK1Freq() / 1000000u) - 1u);
+  HAL_TIM_GenerateEvent(&htim2, TIM_EVENTSOURCE_UPDATE);
+  __HAL_TIM_CLEAR_FLAG(&htim2, TIM_FLAG_UPDATE);
+  if (HAL_TIM_Base_Start_IT(&htim2) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  /* USER CODE END TIM2_Init 2 */
+
+}
+
+void HAL_TIM_Base_MspInit(TIM_HandleTypeDef* tim_baseHandle)
+{
+
+  if(tim_baseHandle->Instance==TIM2)
+  {
+  /* USER CODE BEGIN TIM2_MspInit 0 */
+
+  /* USER CODE END TIM2_MspInit 0 */
+    /* TIM2 clock enable */
+    __HAL_RCC_TIM2_CLK_ENABLE();
+
+    /* TIM2 interrupt Init */
+    HAL_NVIC_SetPriority(TIM2_IRQn, 3, 0);
+    HAL_NVIC_EnableIRQ(TIM2_IRQn);
+  /* USER CODE BEGIN TIM2_MspInit 1 */
+
+  /* USER CODE END TIM2_MspInit 1 */
+  }
+}
+
+void HAL_TIM_Base_MspDeInit(TIM_HandleTypeDef* tim_baseHandle)
+{
+
+  if(tim_baseHandle->Instance==TIM2)
+  {
+  /* USER CODE BEGIN TIM2_MspDeInit 0 */
+
+  /* USER CODE END TIM2_MspDeInit 0 */
+    /* Peripheral clock disable */
+    __HAL_RCC_TIM2_CLK_DISABLE();
+
+    /* TIM2 interrupt Deinit */
+    HAL_NVIC_DisableIRQ(TIM2_IRQn);
+  /* USER CODE BEGIN TIM2_MspDeInit 1 */
+
+  /* USER CODE END TIM2_MspDeInit 1 */
+  }
+}
+
+/* USER CODE BEGIN 1 */
+
+/**
+ * @brief TIM2 update - preteceni 16 bitoveho citace (kazdych 65,536 ms)
+ * 
+ * @param htim 
+ */
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+{
+    if (htim->Instance == TIM2)
+    {
+        tim2Overflows++;
+        TIM_ScheduleCheck();
+    }
+}
+
+/**
+ * @brief TIM2 CC1 - naplanovany cas nastal
+ * 
+ * @param htim 
+ */
+void HAL_TIM_OC_DelayElapsedCallback(TIM_HandleTypeDef *htim)
+{
+    void (*callback)(void);
+
+    if ((htim->Instance == TIM2) && (htim->Channel == HAL_TIM_ACTIVE_CHANNEL_1))
+    {
+        __HAL_TIM_DISABLE_IT(&htim2, TIM_IT_CC1);
+        timSchedCompare = false;
+        callback = timSchedCallback;
+        timSchedCallback = NULL;
+        if (callback != NULL)
+        {
+            callback();
+        }
+    }
+}
+
+/**
+ * @brief Arm CC1 once the target is within one counter period, or fire if it is already due
+ *
+ * Called with interrupts disabled or from TIM2 ISR.
+ * 
+ */
+static void TIM_ScheduleCheck(void)
+{
+    void (*callback)(void) = timSchedCallback;
+    int32_t remain;
+
+    if ((callback == NULL) || timSchedCompare)
+    {
+        return;
+    }
+
+    remain = (int32_t)(timSchedTarget - TIM_GetTimestampUs());
+    if (remain > 0xFFFF)
+    {
+        // Kontrola znovu pri dalsim preteceni
+        return;
+    }
+
+    if (remain > TIM_SCHED_MIN_COMPARE_US)
+    {
+        __HAL_TIM_SET_COMPARE(&htim2, TIM_CHANNEL_1, (uint16_t)timSchedTarget);
+        __HAL_TIM_CLEAR_FLAG(&htim2, TIM_FLAG_CC1);
+        __HAL_TIM_ENABLE_IT(&htim2, TIM_IT_CC1);
+        timSchedCompare = true;
+        return;
+    }
+
+    // Cas uz nastal nebo je prilis blizko pro compare
+    timSchedCallback = NULL;
+    callback();
+}
+
+/**
+ * @brief Call callback from TIM2 ISR at targetUs (TIM_GetTimestampUs time base)
+ *
+ * Only one event can be scheduled, a new one replaces the previous.
+ * Target must be less than 2^31 us ahead.
+ * 
+ * @param targetUs 
+ * @param callback runs in ISR context
+ */
+void TIM_ScheduleAtUs(uint32_t targetUs, void (*callback)(void))
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    __HAL_TIM_DISABLE_IT(&htim2, TIM_IT_CC1);
+    timSchedCompare = false;
+    timSchedTarget = targetUs;
+    timSchedCallback = callback;
+    TIM_ScheduleCheck();
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Cancel event armed by TIM_ScheduleAtUs (no-op if none)
+ * 
+ */
+void TIM_CancelSchedule(void)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    __HAL_TIM_DISABLE_IT(&htim2, TIM_IT_CC1);
+    timSchedCompare = false;
+    timSchedCallback = NULL;
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Free-running 32 bit timestamp in us (wraps after ~71.6 min)
+ *
+ * Callable from task and from ISR (DIO1 EXTI). If the update IRQ is
+ * pending but not yet handled, the overflow is added here.
+ * 
+ * @return uint32_t 
+ */
+uint32_t TIM_GetTimestampUs(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint32_t high;
+    uint16_t low;
+
+    __disable_irq();
+    high = tim2Overflows;
+    low = (uint16_t)__HAL_TIM_GET_COUNTER(&htim2);
+    if ((__HAL_TIM_GET_FLAG(&htim2, TIM_FLAG_UPDATE) != RESET) && (low < 0x8000u))
+    {
+        // Citac pretekl, IRQ jeste nebylo obslouzeno
+        high++;
+    }
+    __set_PRIMASK(primask);
+
+    return (high << 16) | low;
+}
+
+/* USER CODE END 1 */
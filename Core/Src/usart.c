@@ -22,6 +22,7 @@
 
 /* USER CODE BEGIN 0 */
 #include "NVMA.h"
+#include "AT_cmd.h"
 
 /**
  * @brief Get UART baud rate from EEPROM (simplified version for early init)
@@ -31,9 +32,8 @@ static uint32_t GetStoredBaudRate(void)
 {
     uint32_t baud = *((uint32_t *)EE_ADDR_UART_BAUD);
     
-    // Validate - standard baud rates only (max 230400)
-    if (baud == 9600 || baud == 19200 || baud == 38400 || baud == 57600 ||
-        baud == 115200 || baud == 230400)
+    // Validate - same list as AT+UART_BAUD (no mutex needed)
+    if (NVMA_Is_Valid_Baud(baud))
     {
         return baud;
     }
@@ -43,6 +43,7 @@ static uint32_t GetStoredBaudRate(void)
 
 UART_HandleTypeDef huart1;
 DMA_HandleTypeDef hdma_usart1_rx;
+DMA_HandleTypeDef hdma_usart1_tx;
 
 /* USART1 init function */
 
@@ -107,14 +108,14 @@ void HAL_UART_MspInit(UART_HandleTypeDef* uartHandle)
 
     /* USART1 DMA Init */
     /* USART1_RX Init */
-    hdma_usart1_rx.Instance = DMA1_Channel3;
+    hdma_usart1_rx.Instance = DMA1_Channel5;
     hdma_usart1_rx.Init.Request = DMA_REQUEST_3;
     hdma_usart1_rx.Init.Direction = DMA_PERIPH_TO_MEMORY;
     hdma_usart1_rx.Init.PeriphInc = DMA_PINC_DISABLE;
     hdma_usart1_rx.Init.MemInc = DMA_MINC_ENABLE;
     hdma_usart1_rx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
     hdma_usart1_rx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
-    hdma_usart1_rx.Init.Mode = DMA_NORMAL;
+    hdma_usart1_rx.Init.Mode = DMA_CIRCULAR;
     hdma_usart1_rx.Init.Priority = DMA_PRIORITY_LOW;
     if (HAL_DMA_Init(&hdma_usart1_rx) != HAL_OK)
     {
@@ -123,6 +124,23 @@ void HAL_UART_MspInit(UART_HandleTypeDef* uartHandle)
 
     __HAL_LINKDMA(uartHandle,hdmarx,hdma_usart1_rx);
 
+    /* USART1_TX Init */
+    hdma_usart1_tx.Instance = DMA1_Channel4;
+    hdma_usart1_tx.Init.Request = DMA_REQUEST_3;
+    hdma_usart1_tx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    hdma_usart1_tx.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_usart1_tx.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_usart1_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    hdma_usart1_tx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    hdma_usart1_tx.Init.Mode = DMA_NORMAL;
+    hdma_usart1_tx.Init.Priority = DMA_PRIORITY_LOW;
+    if (HAL_DMA_Init(&hdma_usart1_tx) != HAL_OK)
+    {
+      Error_Handler();
+    }
+
+    __HAL_LINKDMA(uartHandle,hdmatx,hdma_usart1_tx);
+
     /* USART1 interrupt Init */
     HAL_NVIC_SetPriority(USART1_IRQn, 3, 0);
     HAL_NVIC_EnableIRQ(USART1_IRQn);
@@ -151,6 +169,7 @@ void HAL_UART_MspDeInit(UART_HandleTypeDef* uartHandle)
 
     /* USART1 DMA DeInit */
     HAL_DMA_DeInit(uartHandle->hdmarx);
+    HAL_DMA_DeInit(uartHandle->hdmatx);
 
     /* USART1 interrupt Deinit */
     HAL_NVIC_DisableIRQ(USART1_IRQn);
@@ -163,7 +182,18 @@ void HAL_UART_MspDeInit(UART_HandleTypeDef* uartHandle)
 /* USER CODE BEGIN 1 */
 int __io_putchar(int ch)
 {
-    HAL_UART_Transmit(&huart1, (uint8_t *)&ch, 1, 42);
+    uint8_t c = (uint8_t)ch;
+
+    // Po startu AT vrstvy jde vse pres DMA Tx ring, jinak by blokujici
+    // prenos kolidoval s rozjetym DMA
+    if (AT_TxReady())
+    {
+        AT_SendData(&c, 1);
+    }
+    else
+    {
+        HAL_UART_Transmit(&huart1, &c, 1, 42);
+    }
     return ch;
 }
 /* USER CODE END 1 */
@@ -0,0 +1,326 @@
+/**
+ * @file AT_binary.c
+ * @author your name (you@domain.com)
+ * @brief Binary host protocol - COBS framed packets with CRC16
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "main.h"
+#include "AT_binary.h"
+#include "AT_cmd.h"
+#include "general_sys_cmd.h"
+
+/**
+ * @brief Incremental COBS encoder writing into wire buffer
+ *
+ */
+typedef struct
+{
+    uint8_t *out;
+    uint16_t pos;       // next free position in out
+    uint16_t codePos;   // position of current code byte
+    uint8_t code;
+
+} ATB_CobsEnc_t;
+
+static uint8_t atbWire[ATB_MAX_WIRE];
+
+/* CRC16-CCITT nibble table */
+static const uint16_t crc16_nibble[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+
+/**
+ * @brief
+ *
+ * @param crc
+ * @param data
+ * @param len
+ * @return uint16_t
+ */
+static uint16_t ATB_Crc16(uint16_t crc, const uint8_t *data, uint16_t len)
+{
+    while (len--)
+    {
+        crc = (uint16_t)((crc << 4) ^ crc16_nibble[((crc >> 12) ^ (*data >> 4)) & 0x0F]);
+        crc = (uint16_t)((crc << 4) ^ crc16_nibble[((crc >> 12) ^ (*data & 0x0F)) & 0x0F]);
+        data++;
+    }
+    return crc;
+}
+
+/**
+ * @brief
+ *
+ * @param enc
+ * @param out
+ */
+static void ATB_CobsStart(ATB_CobsEnc_t *enc, uint8_t *out)
+{
+    enc->out = out;
+    enc->codePos = 0;
+    enc->pos = 1;
+    enc->code = 1;
+}
+
+/**
+ * @brief
+ *
+ * @param enc
+ * @param byte
+ */
+static void ATB_CobsPut(ATB_CobsEnc_t *enc, uint8_t byte)
+{
+    if (byte != 0x00)
+    {
+        enc->out[enc->pos++] = byte;
+        enc->code++;
+    }
+
+    if ((byte == 0x00) || (enc->code == 0xFF))
+    {
+        enc->out[enc->codePos] = enc->code;
+        enc->codePos = enc->pos++;
+        enc->code = 1;
+    }
+}
+
+/**
+ * @brief
+ *
+ * @param enc
+ * @param data
+ * @param len
+ * @param crc running CRC, updated
+ */
+static void ATB_CobsPutBlock(ATB_CobsEnc_t *enc, const uint8_t *data, uint16_t len, uint16_t *crc)
+{
+    *crc = ATB_Crc16(*crc, data, len);
+    for (uint16_t i = 0; i < len; i++)
+    {
+        ATB_CobsPut(enc, data[i]);
+    }
+}
+
+/**
+ * @brief Close the last COBS block and append frame delimiter
+ *
+ * @param enc
+ * @return uint16_t number of wire bytes
+ */
+static uint16_t ATB_CobsFinish(ATB_CobsEnc_t *enc)
+{
+    enc->out[enc->codePos] = enc->code;
+    enc->out[enc->pos++] = 0x00;
+    return enc->pos;
+}
+
+/**
+ * @brief In-place COBS decode (output is never longer than input)
+ *
+ * @param buf
+ * @param len encoded length without 0x00 delimiter
+ * @return int32_t decoded length, -1 on malformed input
+ */
+static int32_t ATB_CobsDecode(uint8_t *buf, uint16_t len)
+{
+    uint16_t in = 0;
+    uint16_t out = 0;
+    uint8_t code;
+
+    while (in < len)
+    {
+        code = buf[in++];
+        if ((code == 0x00) || ((uint16_t)(in + code - 1) > len))
+        {
+            return -1;
+        }
+
+        for (uint8_t i = 1; i < code; i++)
+        {
+            buf[out++] = buf[in++];
+        }
+
+        if ((code != 0xFF) && (in < len))
+        {
+            buf[out++] = 0x00;
+        }
+    }
+
+    return out;
+}
+
+/**
+ * @brief Encode frame from header + up to two payload parts and send it
+ *
+ * @param type
+ * @param part1
+ * @param len1
+ * @param part2
+ * @param len2
+ */
+static void ATB_SendFrame(uint8_t type, const uint8_t *part1, uint16_t len1, const uint8_t *part2, uint16_t len2)
+{
+    ATB_CobsEnc_t enc;
+    uint16_t crc = 0xFFFF;
+    uint8_t header[ATB_HEADER_SIZE];
+    uint8_t crcBytes[ATB_CRC_SIZE];
+
+    if ((len1 + len2) > (ATB_MAX_FRAME - ATB_HEADER_SIZE - ATB_CRC_SIZE))
+    {
+        return;
+    }
+
+    header[0] = type;
+    header[1] = (uint8_t)((len1 + len2) & 0xFF);
+    header[2] = (uint8_t)((len1 + len2) >> 8);
+
+    ATB_CobsStart(&enc, atbWire);
+    ATB_CobsPutBlock(&enc, header, sizeof(header), &crc);
+    ATB_CobsPutBlock(&enc, part1, len1, &crc);
+    ATB_CobsPutBlock(&enc, part2, len2, &crc);
+
+    crcBytes[0] = (uint8_t)(crc & 0xFF);
+    crcBytes[1] = (uint8_t)(crc >> 8);
+    for (uint8_t i = 0; i < ATB_CRC_SIZE; i++)
+    {
+        ATB_CobsPut(&enc, crcBytes[i]);
+    }
+
+    AT_SendData(atbWire, ATB_CobsFinish(&enc));
+}
+
+/**
+ * @brief
+ *
+ * @param reqType
+ * @param status
+ */
+static void ATB_SendStatus(uint8_t reqType, ATB_Status_e status)
+{
+    uint8_t payload[2];
+
+    payload[0] = reqType;
+    payload[1] = (uint8_t)status;
+    ATB_SendFrame(ATB_TYPE_STATUS, payload, sizeof(payload), NULL, 0);
+}
+
+/**
+ * @brief Decode and execute one received frame - called from main task
+ *
+ * @param frame COBS encoded frame without delimiter, decoded in place
+ * @param len
+ */
+void ATB_HandleFrame(uint8_t *frame, uint16_t len)
+{
+    int32_t decLen;
+    uint16_t crc;
+    uint8_t type;
+    uint16_t payloadLen;
+
+    decLen = ATB_CobsDecode(frame, len);
+    if (decLen < (ATB_HEADER_SIZE + ATB_CRC_SIZE))
+    {
+        ATB_SendStatus(0, ATB_STATUS_BAD_LENGTH);
+        return;
+    }
+
+    type = frame[0];
+    payloadLen = (uint16_t)(frame[1] | (frame[2] << 8));
+
+    if (decLen != (int32_t)(ATB_HEADER_SIZE + payloadLen + ATB_CRC_SIZE))
+    {
+        ATB_SendStatus(type, ATB_STATUS_BAD_LENGTH);
+        return;
+    }
+
+    crc = ATB_Crc16(0xFFFF, frame, (uint16_t)(ATB_HEADER_SIZE + payloadLen));
+    if ((frame[decLen - 2] != (uint8_t)(crc & 0xFF)) || (frame[decLen - 1] != (uint8_t)(crc >> 8)))
+    {
+        ATB_SendStatus(type, ATB_STATUS_CRC_ERROR);
+        return;
+    }
+
+    switch (type)
+    {
+        case ATB_TYPE_TX:
+            if ((payloadLen == 0) || (payloadLen > ATB_MAX_PAYLOAD))
+            {
+                ATB_SendStatus(type, ATB_STATUS_BAD_LENGTH);
+                break;
+            }
+            if (GSC_SendRfPacket(&frame[ATB_HEADER_SIZE], (uint8_t)payloadLen) == 0)
+            {
+                ATB_SendStatus(type, ATB_STATUS_TX_FULL);
+                break;
+            }
+            ATB_SendStatus(type, ATB_STATUS_OK);
+            break;
+
+        case ATB_TYPE_PING:
+            ATB_SendStatus(type, ATB_STATUS_OK);
+            break;
+
+        case ATB_TYPE_EXIT:
+            ATB_SendStatus(type, ATB_STATUS_OK);
+            AT_SetBinaryMode(false);
+            break;
+
+        default:
+            ATB_SendStatus(type, ATB_STATUS_UNKNOWN_TYPE);
+            break;
+    }
+}
+
+/**
+ * @brief Send received RF packet as ATB_TYPE_RX frame
+ *
+ * @param pkt
+ */
+void ATB_SendRxPacket(packet_info_t *pkt)
+{
+    uint8_t meta[ATB_RX_META_SIZE];
+
+    meta[0] = (uint8_t)((uint16_t)pkt->rx_rssi & 0xFF);
+    meta[1] = (uint8_t)((uint16_t)pkt->rx_rssi >> 8);
+    meta[2] = (uint8_t)pkt->rx_snr;
+    meta[3] = (uint8_t)(pkt->rx_time_us & 0xFF);
+    meta[4] = (uint8_t)((pkt->rx_time_us >> 8) & 0xFF);
+    meta[5] = (uint8_t)((pkt->rx_time_us >> 16) & 0xFF);
+    meta[6] = (uint8_t)(pkt->rx_time_us >> 24);
+
+    ATB_SendFrame(ATB_TYPE_RX, meta, sizeof(meta), pkt->packet, pkt->size);
+}
+
+/**
+ * @brief
+ *
+ * @param id
+ * @param toaMs
+ * @param doneUs TX done timestamp
+ * @param sent
+ */
+void ATB_SendTxDone(uint16_t id, uint32_t toaMs, uint32_t doneUs, bool sent)
+{
+    uint8_t payload[11];
+
+    payload[0] = (uint8_t)(id & 0xFF);
+    payload[1] = (uint8_t)(id >> 8);
+    payload[2] = (uint8_t)(toaMs & 0xFF);
+    payload[3] = (uint8_t)((toaMs >> 8) & 0xFF);
+    payload[4] = (uint8_t)((toaMs >> 16) & 0xFF);
+    payload[5] = (uint8_t)(toaMs >> 24);
+    payload[6] = sent ? 1 : 0;
+    payload[7] = (uint8_t)(doneUs & 0xFF);
+    payload[8] = (uint8_t)((doneUs >> 8) & 0xFF);
+    payload[9] = (uint8_t)((doneUs >> 16) & 0xFF);
+    payload[10] = (uint8_t)(doneUs >> 24);
+
+    ATB_SendFrame(ATB_TYPE_TX_DONE, payload, sizeof(payload), NULL, 0);
+}
@@ -0,0 +1,62 @@
+/**
+ * @file AT_binary.h
+ * @author your name (you@domain.com)
+ * @brief Binary host protocol - COBS framed packets with CRC16
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Wire format:  COBS( type | len_lo | len_hi | payload[len] | crc16_lo | crc16_hi ) 0x00
+ * CRC16-CCITT (poly 0x1021, init 0xFFFF) over type, len and payload.
+ */
+#ifndef AT_BINARY_H
+#define AT_BINARY_H
+
+#include "main.h"
+#include "radio_user.h"
+
+#define ATB_MAX_PAYLOAD         255
+#define ATB_HEADER_SIZE         3       // type + len (uint16 LE)
+#define ATB_CRC_SIZE            2
+#define ATB_RX_META_SIZE        7       // rssi(2) + snr(1) + timestamp(4)
+#define ATB_MAX_FRAME           (ATB_HEADER_SIZE + ATB_MAX_PAYLOAD + ATB_RX_META_SIZE + ATB_CRC_SIZE)
+#define ATB_MAX_WIRE            (ATB_MAX_FRAME + (ATB_MAX_FRAME / 254) + 2)                 // COBS overhead + delimiter
+
+/**
+ * @brief Frame types
+ *
+ */
+typedef enum
+{
+    /* host -> dongle */
+    ATB_TYPE_TX         = 0x01,     // payload = RF data
+    ATB_TYPE_PING       = 0x02,     // no payload, answered with STATUS
+    ATB_TYPE_EXIT       = 0x03,     // leave binary mode (back to AT)
+
+    /* dongle -> host */
+    ATB_TYPE_RX         = 0x81,     // payload = rssi(int16 LE) | snr(int8) | time_us(uint32 LE) | RF data
+    ATB_TYPE_STATUS     = 0x82,     // payload = request type | status
+    ATB_TYPE_TX_DONE    = 0x83,     // payload = id(uint16 LE) | toa_ms(uint32 LE) | sent(uint8) | time_us(uint32 LE)
+
+} ATB_Type_e;
+
+/**
+ * @brief Status codes in ATB_TYPE_STATUS frame
+ *
+ */
+typedef enum
+{
+    ATB_STATUS_OK           = 0x00,
+    ATB_STATUS_CRC_ERROR    = 0x01,
+    ATB_STATUS_BAD_LENGTH   = 0x02,
+    ATB_STATUS_UNKNOWN_TYPE = 0x03,
+    ATB_STATUS_TX_FULL      = 0x04,
+
+} ATB_Status_e;
+
+void ATB_HandleFrame(uint8_t *frame, uint16_t len);
+void ATB_SendRxPacket(packet_info_t *pkt);
+void ATB_SendTxDone(uint16_t id, uint32_t toaMs, uint32_t doneUs, bool sent);
+
+#endif // AT_BINARY_H
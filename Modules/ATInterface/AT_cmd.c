@@ -17,6 +17,8 @@
 #include "Main_task.h"
 #include "semphr.h"
 #include "NVMA.h"
+#include "AT_binary.h"
+#include "general_sys_cmd.h"
 
 
 /**
@@ -28,12 +30,23 @@ static void AT_HandleFactoryReset(char *params);
 static void AT_HandleHelp(char *params);
 static void AT_HandleRestartSys(char *params);
 static void AT_HandleIdentify(char *params);
+static void AT_HandleBinMode(char *params);
+static void AT_HandleStream(char *params);
+static void AT_HandleUartStat(char *params);
+static void AT_HandleATCommand(char *data);
+static void AT_DrainRx(void);
+static void AT_RxRestarted(void);
+static void AT_SetRxMode(AT_RxMode_e mode);
+static void AT_StreamPoll(void);
 
 extern UART_HandleTypeDef huart1;
 extern osMessageQueueId_t queueMainHandle;
 
 AT_cmd_t at_ctx;
 SemaphoreHandle_t xUART_TXSemaphore;
+static SemaphoreHandle_t xUART_TxSpaceSemaphore;   // DMA uvolnil misto v Tx ringu
+
+static AT_CmdSlot_t cmdFifo[AT_CMD_FIFO_DEPTH];
 
 /**
  * @brief 
@@ -46,78 +59,220 @@ typedef struct
     void (*simpleHandler)(char *params);            // Handler bez pevneho parametru
     eATCommands cmdtoCore;
   //  bool isFixedParamUsed;
-    const char *usage;   
-    const char *parameters;
 } AT_Command_Struct;
 
 // Společná reference table
 #define BW_TABLE "BW index: 0=7.81, 1=10.42, 2=15.63, 3=20.83, 4=31.25, 5=41.67, 6=62.5, 7=125, 8=250, 9=500 kHz"
+
+/* AT commands, one list per AT+HELP section:
+   X(command, simpleHandler, cmdtoCore, usage, parameters) or XN(...) without parameters.
+   Both the lookup table and the pre-rendered help text are expanded from these lists */
+#define AT_CMDS_BASIC(X, XN) \
+    XN("AT",                     AT_HandleHelp,          0,                          "AT - Basic test command") \
+    XN("AT+HELP",                AT_HandleHelp,          0,                          "AT+HELP - List all supported commands") \
+    XN("AT+IDENTIFY",            AT_HandleIdentify,      0,                          "AT+IDENTIFY - Identify the device (returns unique ID)") \
+    XN("AT+FACTORY_RST",         AT_HandleFactoryReset,  0,                          "AT+FACTORY_RST - Reset all settings to defaults") \
+    XN("AT+SYS_RESTART",         AT_HandleRestartSys,    0,                          "AT+SYS_RESTART - Restart the system") \
+    X("AT+BIN_MODE",             AT_HandleBinMode,       0,                          "AT+BIN_MODE - Switch to binary COBS protocol (leave with EXIT frame)", "=1, ?") \
+    X("AT+STREAM",               AT_HandleStream,        0,                          "AT+STREAM - Transparent UART->RF mode (leave with +++)", "=<max_len:1-255>[,<gap_ms>], ?") \
+    X("AT+UART_BAUD",            NULL,                   SYS_CMD_UART_BAUD,          "AT+UART_BAUD - Set UART baud rate (no reset)", "=9600..2000000[,TEMP], ?") \
+    X("AT+UART_STAT",            AT_HandleUartStat,      0,                          "AT+UART_STAT - UART: cmd FIFO max,full,Rx events lost,long lines,Rx overruns, Tx ring max,waits,dropped", "?")
+
+#define AT_CMDS_LORA(X, XN) \
+    X("AT+LR_TX_FREQ",           NULL,                   SYS_CMD_TX_FREQ,            "AT+LR_TX_FREQ - Set TX frequency", "=<frequency_in_Hz>, ?") \
+    X("AT+LR_RX_FREQ",           NULL,                   SYS_CMD_RX_FREQ,            "AT+LR_RX_FREQ - Set RX frequency", "=<frequency_in_Hz>, ?") \
+    X("AT+LR_TX_POWER",          NULL,                   SYS_CMD_TX_POWER,           "AT+LR_TX_POWER - Set TX power", "=<power_in_dBm>, ?") \
+    X("AT+LR_TX_SF",             NULL,                   SYS_CMD_TX_SF,              "AT+LR_TX_SF - Set TX spreading factor", "=5 to 12, ?") \
+    X("AT+LR_RX_SF",             NULL,                   SYS_CMD_RX_SF,              "AT+LR_RX_SF - Set RX spreading factor", "=5 to 12, ?") \
+    X("AT+LR_TX_BW",             NULL,                   SYS_CMD_TX_BW,              "AT+LR_TX_BW - Set TX bandwidth", BW_TABLE) \
+    X("AT+LR_RX_BW",             NULL,                   SYS_CMD_RX_BW,              "AT+LR_RX_BW - Set RX bandwidth", BW_TABLE) \
+    X("AT+LR_TX_IQ_INV",         NULL,                   SYS_CMD_TX_IQ,              "AT+LR_TX_IQ_INV - Set TX IQ inversion", "=1, =0, ?") \
+    X("AT+LR_RX_IQ_INV",         NULL,                   SYS_CMD_RX_IQ,              "AT+LR_RX_IQ_INV - Set RX IQ inversion", "=1, =0, ?") \
+    X("AT+LR_TX_CR",             NULL,                   SYS_CMD_TX_CR,              "AT+LR_TX_CR - Set TX coding rate", "=45, =46, =47, =48, ?") \
+    X("AT+LR_RX_CR",             NULL,                   SYS_CMD_RX_CR,              "AT+LR_RX_CR - Set RX coding rate", "=45, =46, =47, =48, ?") \
+    X("AT+LR_TX_HEADERMODE",     NULL,                   SYS_CMD_HEADERMODE_TX,      "AT+LR_TX_HEADERMODE - Enable TX header mode, explicit = 0", "=1, =0, ?") \
+    X("AT+LR_RX_HEADERMODE",     NULL,                   SYS_CMD_HEADERMODE_RX,      "AT+LR_RX_HEADERMODE - Enable RX header mode, explicit = 0", "=1, =0, ?") \
+    X("AT+LR_TX_CRC",            NULL,                   SYS_CMD_CRC_TX,             "AT+LR_TX_CRC - Set TX CRC check", "=1, =0, ?") \
+    X("AT+LR_RX_CRC",            NULL,                   SYS_CMD_CRC_RX,             "AT+LR_RX_CRC - Set RX CRC check", "=1, =0, ?") \
+    X("AT+LR_TX_PREAMBLE_SIZE",  NULL,                   SYS_CMD_PREAM_SIZE_TX,      "AT+LR_TX_PREAMBLE_SIZE", "=<1 to 65535>, optimum >=8, ?") \
+    X("AT+LR_RX_PREAMBLE_SIZE",  NULL,                   SYS_CMD_PREAM_SIZE_RX,      "AT+LR_RX_PREAMBLE_SIZE", "=<1 to 65535> should be >= TX side,?") \
+    X("AT+LR_TX_LDRO",           NULL,                   SYS_CMD_TX_LDRO,            "AT+LR_TX_LDRO - Set TX Low Data Rate Optimization", "=0 (off), =1 (on), =2 (auto), ?") \
+    X("AT+LR_RX_LDRO",           NULL,                   SYS_CMD_RX_LDRO,            "AT+LR_RX_LDRO - Set RX Low Data Rate Optimization", "=0 (off), =1 (on), =2 (auto), ?") \
+    X("AT+LR_TX_SYNCWORD",       NULL,                   SYS_CMD_TX_SYNCWORD,        "AT+LR_TX_SYNCWORD - Set TX sync word (0x12 or 0x34)", "=<hex_byte>, ?") \
+    X("AT+LR_RX_SYNCWORD",       NULL,                   SYS_CMD_RX_SYNCWORD,        "AT+LR_RX_SYNCWORD - Set RX sync word (0x12 or 0x34)", "=<hex_byte>, ?") \
+    X("AT+LR_RX_PLDLEN",         NULL,                   SYS_CMD_RX_PLDLEN,          "AT+LR_RX_PLDLEN - RX payload length (required only for implicit mode)", "=<1-255>, ?") \
+    X("AT+LR_TX_SET",            NULL,                   SYS_CMD_TX_COMPLETE_SET,    "AT+LR_TX_SET - Set multiple TX params", "=SF:<5-12>,BW:<0-9>,CR:<45-48>,Freq:<Hz>,IQInv:<0|1>,HeaderMode:<0|1>,CRC:<0|1>,Preamble:<1-65535>,LDRO:<0|1|2>,Power:<dBm>, ?") \
+    X("AT+LR_RX_SET",            NULL,                   SYS_CMD_RX_COMPLETE_SET,    "AT+LR_RX_SET - Set multiple RX params", "=SF:<5-12>,BW:<0-9>,CR:<45-48>,Freq:<Hz>,IQInv:<0|1>,HeaderMode:<0|1>,CRC:<0|1>,Preamble:<1-65535>,LDRO:<0|1|2>, ?")
+
+#define AT_CMDS_RF(X, XN) \
+    X("AT+RF_TX_HEX",            NULL,                   SYS_CMD_RF_TX_HEX,          "AT+RF_TX_HEX - Transmit data via RF in HEX format", "=<HEX data>") \
+    X("AT+RF_TX_TXT",            NULL,                   SYS_CMD_RF_TX_TXT,          "AT+RF_TX_TXT - Transmit data via RF in text format", "=<Text data>") \
+    X("AT+RF_TX_LBT",            NULL,                   SYS_CMD_RF_TX_LBT,          "AT+RF_TX_LBT - Transmit HEX data after CAD finds the channel free", "=<HEX data>") \
+    X("AT+RF_LBT_CFG",           NULL,                   SYS_CMD_RF_LBT_CFG,         "AT+RF_LBT_CFG - CAD and backoff settings for RF_TX_LBT", "=<symb>,<det_peak>,<det_min>,<attempts>,<backoff_ms>, ?") \
+    X("AT+RF_LBT_STAT",          NULL,                   SYS_CMD_RF_LBT_STAT,        "AT+RF_LBT_STAT - LBT stats: CAD runs,busy,sent,dropped", "?") \
+    X("AT+RF_TX_SCHED",          NULL,                   SYS_CMD_RF_TX_SCHED,        "AT+RF_TX_SCHED - Transmit HEX data at time_us (+ = relative), ? = current time", "=<[+]time_us>,<HEX data>, ?") \
+    X("AT+RF_SCHED_STAT",        NULL,                   SYS_CMD_RF_SCHED_STAT,      "AT+RF_SCHED_STAT - Scheduled TX: sent,late,deferred,last/max jitter us", "?") \
+    X("AT+RF_TX_LRFHSS",         NULL,                   SYS_CMD_RF_TX_LRFHSS,       "AT+RF_TX_LRFHSS - Transmit HEX data with LR-FHSS (TX freq and power)", "=<HEX data>") \
+    X("AT+LRFHSS_CR",            NULL,                   SYS_CMD_LRFHSS_CR,          "AT+LRFHSS_CR - LR-FHSS coding rate", "=0 (5/6), =1 (2/3), =2 (1/2), =3 (1/3), ?") \
+    X("AT+LRFHSS_BW",            NULL,                   SYS_CMD_LRFHSS_BW,          "AT+LRFHSS_BW - LR-FHSS bandwidth and grid", "=<bw:0-9>,<grid:0=25.4|1=3.9 kHz>, ?") \
+    X("AT+LRFHSS_HOPSEQ",        NULL,                   SYS_CMD_LRFHSS_HOPSEQ,      "AT+LRFHSS_HOPSEQ - LR-FHSS hop sequence ID", "=<0-511>, =RND, ?") \
+    X("AT+LRFHSS_SYNC",          NULL,                   SYS_CMD_LRFHSS_SYNC,        "AT+LRFHSS_SYNC - LR-FHSS sync word", "=<8 HEX digits>, ?") \
+    X("AT+RF_MODEM",             NULL,                   SYS_CMD_RF_MODEM,           "AT+RF_MODEM - Modem for TX and RX (GFSK uses LR_TX/RX freq and power)", "=LORA|GFSK, ?") \
+    X("AT+GFSK_BITRATE",         NULL,                   SYS_CMD_GFSK_BITRATE,       "AT+GFSK_BITRATE - GFSK bitrate in bps", "=<600-300000>, ?") \
+    X("AT+GFSK_FDEV",            NULL,                   SYS_CMD_GFSK_FDEV,          "AT+GFSK_FDEV - GFSK frequency deviation in Hz", "=<600-200000>, ?") \
+    X("AT+GFSK_BW",              NULL,                   SYS_CMD_GFSK_BW,            "AT+GFSK_BW - GFSK RX bandwidth in Hz (>= 2*fdev + bitrate)", "=<4800-467000>, ?") \
+    X("AT+GFSK_PREAMBLE",        NULL,                   SYS_CMD_GFSK_PREAMBLE,      "AT+GFSK_PREAMBLE - GFSK preamble length in bits", "=<8-65535>, ?") \
+    X("AT+GFSK_SYNC",            NULL,                   SYS_CMD_GFSK_SYNC,          "AT+GFSK_SYNC - GFSK sync word (1-8 bytes)", "=<HEX>, ?") \
+    X("AT+GFSK_CRC",             NULL,                   SYS_CMD_GFSK_CRC,           "AT+GFSK_CRC - GFSK CRC", "=0 (off), =1 (1 B), =2 (2 B), =3 (1 B inv), =4 (2 B inv), ?") \
+    X("AT+GFSK_WHITENING",       NULL,                   SYS_CMD_GFSK_WHITENING,     "AT+GFSK_WHITENING - GFSK data whitening", "=1 (ON), =0 (OFF), ?") \
+    X("AT+RF_SAVE_PACKET",       NULL,                   SYS_CMD_RF_SAVE_PCKT_NVM,   "AT+RF_SAVE_PACKET - Save packet to memory", "=<HEX data>, ?") \
+    XN("AT+RF_TX_SAVED",         NULL,                   SYS_CMD_RF_TX_NVM_ONCE,     "AT+RF_TX_SAVED - Send saved packet once") \
+    X("AT+RF_TX_SAVED_REPEAT",   NULL,                   SYS_CMD_RF_TX_PERIODIC_NVM, "AT+RF_TX_SAVED_REPEAT - Start/Stop periodic saved packet TX", "=1 (ON), =0 (OFF), ?") \
+    X("AT+RF_TX_NVM_PERIOD",     NULL,                   SYS_CMD_RF_TX_NVM_PERIOD,   "AT+RF_TX_NVM_PERIOD - Set period for saved packet TX", "=<period_ms>, ?") \
+    X("AT+RF_TX_PERIOD_STATUS",  NULL,                   SYS_CMD_RF_PERIOD_STATUS,   "AT+RF_TX_PERIOD_STATUS - Get periodic TX status", "?") \
+    X("AT+RF_TX_CW",             NULL,                   SYS_CMD_TX_CW,              "AT+RF_TX_CW - Start/Stop TX CW mode", "=1 (ON), =0 (OFF), ?") \
+    X("AT+RF_RX_TO_UART",        NULL,                   SYS_CMD_RF_RX_TO_UART,      "AT+RF_RX_TO_UART - Auto-print received RF data to serial", "=1 (ON), =0 (OFF), ?") \
+    X("AT+RF_RX_SNIFF",          NULL,                   SYS_CMD_RX_SNIFF,           "AT+RF_RX_SNIFF - Low-power RX duty-cycle derived from RX preamble", "=1 (ON), =0 (OFF), ?") \
+    X("AT+RF_RX_FORMAT",         NULL,                   SYS_CMD_RX_FORMAT,          "AT+RF_RX_FORMAT - Set RX output format", "=HEX|ASCII, ?") \
+    X("AT+RF_GET_TOA",           NULL,                   SYS_CMD_RF_GET_TOA,         "AT+RF_GET_TOA - Get TOA (TX config)", "=<packet_size_bytes>") \
+    XN("AT+RF_GET_TSYM",         NULL,                   SYS_CMD_RF_GET_TSYM,        "AT+RF_GET_TSYM - Get symbol time in us (TX config)") \
+    X("AT+RF_RX_STAT",           NULL,                   SYS_CMD_RF_RX_STAT,         "AT+RF_RX_STAT - RX stats: packets,fast re-arms,full re-arms,last gap us,max gap us", "?") \
+    X("AT+RF_POOL_STAT",         NULL,                   SYS_CMD_RF_POOL_STAT,       "AT+RF_POOL_STAT - Packet pool: RX used,max,dropped, TX used,max,full", "?") \
+    X("AT+RF_BUSY_STAT",         NULL,                   SYS_CMD_RF_BUSY_STAT,       "AT+RF_BUSY_STAT - SX126x BUSY: waits,blocked,timeouts,last us,max us,radio resets", "?") \
+    X("AT+RF_SPI_STAT",          NULL,                   SYS_CMD_RF_SPI_STAT,        "AT+RF_SPI_STAT - SX126x SPI: frames,BUSY checks,locks,batches,last batch frames,BUSY checks,errors", "?")
+
+#define AT_CMDS_AUX(X, XN) \
+    X("AT+AUX",                  NULL,                   SYS_CMD_AUX_SET,            "Set AUX pin state", "=<pin:1-8>,<state:0|1>") \
+    X("AT+AUX_PULSE",            NULL,                   SYS_CMD_AUX_PULSE,          "Start PWM on AUX pin", "=<pin:1-8>,<period_ms>,<duty%:0-100>") \
+    X("AT+AUX_PULSE_STOP",       NULL,                   SYS_CMD_AUX_STOP,           "Stop PWM on AUX pin", "=<pin:1-8>")
+
+#define AT_CMD_ROW(cmd, handler, core, usage, par)      {cmd, handler, core},
+#define AT_CMD_ROW_NP(cmd, handler, core, usage)        {cmd, handler, core},
+#define AT_HELP_LINE(cmd, handler, core, usage, par)    usage " (Par: " par ")\r\n"
+#define AT_HELP_LINE_NP(cmd, handler, core, usage)      usage "\r\n"
+
 /* Table of AT commands */
 const AT_Command_Struct AT_Commands[] = {
-    {"AT",                       AT_HandleHelp,          0,                                 "AT - Basic test command",                         ""},
-    {"AT+HELP",                  AT_HandleHelp,          0,                                 "AT+HELP - List all supported commands",           ""},
-    {"AT+IDENTIFY",              AT_HandleIdentify,      0,                                 "AT+IDENTIFY - Identify the device (returns unique ID)",               ""},
-    {"AT+FACTORY_RST",           AT_HandleFactoryReset,  0,                                 "AT+FACTORY_RST - Reset all settings to defaults",      ""},
-    {"AT+SYS_RESTART",           AT_HandleRestartSys,    0,                                 "AT+SYS_RESTART - Restart the system",             ""},
-    /* single LoRa params*/
-    {"AT+LR_TX_FREQ",                NULL,               SYS_CMD_TX_FREQ,                     "AT+LR_TX_FREQ - Set TX frequency",                "=<frequency_in_Hz>, ?"},
-    {"AT+LR_RX_FREQ",                NULL,               SYS_CMD_RX_FREQ,                     "AT+LR_RX_FREQ - Set RX frequency",                "=<frequency_in_Hz>, ?"},
-    {"AT+LR_TX_POWER",               NULL,               SYS_CMD_TX_POWER,                    "AT+LR_TX_POWER - Set TX power",                   "=<power_in_dBm>, ?"},
-    {"AT+LR_TX_SF",                  NULL,               SYS_CMD_TX_SF,                       "AT+LR_TX_SF - Set TX spreading factor",           "=5 to 12, ?"},
-    {"AT+LR_RX_SF",                  NULL,               SYS_CMD_RX_SF,                       "AT+LR_RX_SF - Set RX spreading factor",           "=5 to 12, ?"},
-    {"AT+LR_TX_BW",                 NULL,               SYS_CMD_TX_BW,                       "AT+LR_TX_BW - Set TX bandwidth",                                 BW_TABLE},
-    {"AT+LR_RX_BW",                 NULL,               SYS_CMD_RX_BW,                       "AT+LR_RX_BW - Set RX bandwidth",                                 BW_TABLE},
-    {"AT+LR_TX_IQ_INV",              NULL,               SYS_CMD_TX_IQ,                       "AT+LR_TX_IQ_INV - Set TX IQ inversion",           "=1, =0, ?"},
-    {"AT+LR_RX_IQ_INV",              NULL,               SYS_CMD_RX_IQ,                       "AT+LR_RX_IQ_INV - Set RX IQ inversion",           "=1, =0, ?"},
-    {"AT+LR_TX_CR",                  NULL,               SYS_CMD_TX_CR,                       "AT+LR_TX_CR - Set TX coding rate",                "=45, =46, =47, =48, ?"},
-    {"AT+LR_RX_CR",                  NULL,               SYS_CMD_RX_CR,                       "AT+LR_RX_CR - Set RX coding rate",                "=45, =46, =47, =48, ?"},
-    {"AT+LR_TX_HEADERMODE",         NULL,               SYS_CMD_HEADERMODE_TX,               "AT+LR_TX_HEADERMODE - Enable TX header mode, explicit = 0",    "=1, =0, ?"},
-    {"AT+LR_RX_HEADERMODE",         NULL,               SYS_CMD_HEADERMODE_RX,               "AT+LR_RX_HEADERMODE - Enable RX header mode, explicit = 0",    "=1, =0, ?"},
-    {"AT+LR_TX_CRC",                NULL,               SYS_CMD_CRC_TX,                      "AT+LR_TX_CRC - Set TX CRC check",                "=1, =0, ?"},
-    {"AT+LR_RX_CRC",                NULL,               SYS_CMD_CRC_RX,                      "AT+LR_RX_CRC - Set RX CRC check",                "=1, =0, ?"},
-    {"AT+LR_TX_PREAMBLE_SIZE",      NULL,               SYS_CMD_PREAM_SIZE_TX,               "AT+LR_TX_PREAMBLE_SIZE",                         "=<1 to 65535>, optimum >=8, ?"  },
-    {"AT+LR_RX_PREAMBLE_SIZE",      NULL,               SYS_CMD_PREAM_SIZE_RX,               "AT+LR_RX_PREAMBLE_SIZE",                         "=<1 to 65535> should be >= TX side,?"},
-    {"AT+LR_TX_LDRO",               NULL,               SYS_CMD_TX_LDRO,                     "AT+LR_TX_LDRO - Set TX Low Data Rate Optimization", "=0 (off), =1 (on), =2 (auto), ?"},
-    {"AT+LR_RX_LDRO",               NULL,               SYS_CMD_RX_LDRO,                     "AT+LR_RX_LDRO - Set RX Low Data Rate Optimization", "=0 (off), =1 (on), =2 (auto), ?"},
-
-    {"AT+LR_TX_SYNCWORD",           NULL,               SYS_CMD_TX_SYNCWORD,                  "AT+LR_TX_SYNCWORD - Set TX sync word (0x12 or 0x34)", "=<hex_byte>, ?"},
-    {"AT+LR_RX_SYNCWORD",           NULL,               SYS_CMD_RX_SYNCWORD,                  "AT+LR_RX_SYNCWORD - Set RX sync word (0x12 or 0x34)", "=<hex_byte>, ?"},
-    {"AT+LR_RX_PLDLEN",             NULL,               SYS_CMD_RX_PLDLEN,                   "AT+LR_RX_PLDLEN - RX payload length (required only for implicit mode)", "=<1-255>, ?"},
- 
-    /* RF immediate TX commands */
-    {"AT+RF_TX_HEX",                NULL,               SYS_CMD_RF_TX_HEX,                   "AT+RF_TX_HEX - Transmit data via RF in HEX format",  "=<HEX data>"},
-    {"AT+RF_TX_TXT",                NULL,               SYS_CMD_RF_TX_TXT,                   "AT+RF_TX_TXT - Transmit data via RF in text format", "=<Text data>"},
-    
-    /* RF saved packet commands */
-    {"AT+RF_SAVE_PACKET",           NULL,               SYS_CMD_RF_SAVE_PCKT_NVM,            "AT+RF_SAVE_PACKET - Save packet to memory",       "=<HEX data>, ?"},
-    {"AT+RF_TX_SAVED",              NULL,               SYS_CMD_RF_TX_NVM_ONCE,              "AT+RF_TX_SAVED - Send saved packet once",         ""},
-    {"AT+RF_TX_SAVED_REPEAT",       NULL,               SYS_CMD_RF_TX_PERIODIC_NVM,          "AT+RF_TX_SAVED_REPEAT - Start/Stop periodic saved packet TX", "=1 (ON), =0 (OFF), ?"},
-    {"AT+RF_TX_NVM_PERIOD",         NULL,               SYS_CMD_RF_TX_NVM_PERIOD,            "AT+RF_TX_NVM_PERIOD - Set period for saved packet TX",   "=<period_ms>, ?"},
-    {"AT+RF_TX_PERIOD_STATUS",      NULL,               SYS_CMD_RF_PERIOD_STATUS,            "AT+RF_TX_PERIOD_STATUS - Get periodic TX status",     "?"},
-    {"AT+RF_TX_CW",                 NULL,               SYS_CMD_TX_CW,                       "AT+RF_TX_CW - Start/Stop TX CW mode", "=1 (ON), =0 (OFF), ?"},
-
-    /* RF RX commands */
-    {"AT+RF_RX_TO_UART",            NULL,               SYS_CMD_RF_RX_TO_UART,               "AT+RF_RX_TO_UART - Auto-print received RF data to serial",            "=1 (ON), =0 (OFF), ?"},
-    {"AT+RF_RX_FORMAT",             NULL,               SYS_CMD_RX_FORMAT,                   "AT+RF_RX_FORMAT - Set RX output format", "=HEX|ASCII, ?"},
-    
-    /* RF TOA command */
-    {"AT+RF_GET_TOA",               NULL,               SYS_CMD_RF_GET_TOA,                  "AT+RF_GET_TOA - Get TOA (TX config)",             "=<packet_size_bytes>"},
-    {"AT+RF_GET_TSYM",              NULL,               SYS_CMD_RF_GET_TSYM,                 "AT+RF_GET_TSYM - Get symbol time in us (TX config)", ""},
-    
-    /* AUX GPIO commands */
-    {"AT+AUX",            NULL, SYS_CMD_AUX_SET,   "Set AUX pin state", "=<pin:1-8>,<state:0|1>"},
-    {"AT+AUX_PULSE",      NULL, SYS_CMD_AUX_PULSE, "Start PWM on AUX pin", "=<pin:1-8>,<period_ms>,<duty%:0-100>"},
-    {"AT+AUX_PULSE_STOP", NULL, SYS_CMD_AUX_STOP,  "Stop PWM on AUX pin", "=<pin:1-8>"},
-    /* System commands */
-    {"AT+UART_BAUD",                NULL,               SYS_CMD_UART_BAUD,                   "AT+UART_BAUD - Set UART baud rate", "=9600|19200|38400|57600|115200|230400, ?"},
-    
-    /* multiple LoRa params - set all at once */
-    {"AT+LR_TX_SET",                NULL,               SYS_CMD_TX_COMPLETE_SET,             "AT+LR_TX_SET - Set multiple TX params",      "=SF:<5-12>,BW:<0-9>,CR:<45-48>,Freq:<Hz>,IQInv:<0|1>,HeaderMode:<0|1>,CRC:<0|1>,Preamble:<1-65535>,LDRO:<0|1|2>,Power:<dBm>, ?"},
-    {"AT+LR_RX_SET",                NULL,               SYS_CMD_RX_COMPLETE_SET,             "AT+LR_RX_SET - Set multiple RX params",      "=SF:<5-12>,BW:<0-9>,CR:<45-48>,Freq:<Hz>,IQInv:<0|1>,HeaderMode:<0|1>,CRC:<0|1>,Preamble:<1-65535>,LDRO:<0|1|2>, ?"}
-
+    AT_CMDS_BASIC(AT_CMD_ROW, AT_CMD_ROW_NP)
+    AT_CMDS_LORA(AT_CMD_ROW, AT_CMD_ROW_NP)
+    AT_CMDS_RF(AT_CMD_ROW, AT_CMD_ROW_NP)
+    AT_CMDS_AUX(AT_CMD_ROW, AT_CMD_ROW_NP)
 };
 
+/* AT+HELP output rendered by the compiler into one flash string, sent by a single DMA transfer */
+static const char AT_HelpText[] =
+    "\r\nSupported AT commands:\r\n"
+    "\r\n--- Basic ---\r\n"
+    AT_CMDS_BASIC(AT_HELP_LINE, AT_HELP_LINE_NP)
+    "\r\n--- LoRa Radio ---\r\n"
+    AT_CMDS_LORA(AT_HELP_LINE, AT_HELP_LINE_NP)
+    "\r\n--- RF ---\r\n"
+    AT_CMDS_RF(AT_HELP_LINE, AT_HELP_LINE_NP)
+    "\r\n--- AUX GPIO ---\r\n"
+    AT_CMDS_AUX(AT_HELP_LINE, AT_HELP_LINE_NP)
+    "\r\nExamples for complex commands:\r\n"
+    "  AT+LR_TX_SET=SF:9,BW:7,CR:45,Freq:869525000,IQInv:0,HeaderMode:0,CRC:1,Preamble:8,Power:22,LDRO:2\r\n"
+    "  AT+LR_RX_SET=SF:9,BW:7,CR:45,Freq:869525000,IQInv:0,HeaderMode:0,CRC:1,Preamble:8,LDRO:2\r\n";
+
+#define AT_CMD_COUNT            (sizeof(AT_Commands) / sizeof(AT_Command_Struct))
+#define AT_CMD_MAX_NAME_LEN     24
+
+/* Lookup index built once in AT_Init(): command indexes sorted by name length
+   (bucket per length) plus a case-insensitive hash of every name, so a line
+   costs one bucket scan of a few hash compares and a single strncasecmp */
+static uint8_t  cmdIndex[AT_CMD_COUNT];
+static uint8_t  cmdBucket[AT_CMD_MAX_NAME_LEN + 2];
+static uint16_t cmdHash[AT_CMD_COUNT];
+
+
+
+
+/**
+ * @brief Case-insensitive FNV-1a hash of command name
+ * 
+ * @param name 
+ * @param len 
+ * @return uint16_t 
+ */
+static uint16_t AT_NameHash(const char *name, size_t len)
+{
+    uint32_t hash = 2166136261UL;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        hash ^= (uint8_t)toupper((unsigned char)name[i]);
+        hash *= 16777619UL;
+    }
+
+    return (uint16_t)(hash ^ (hash >> 16));
+}
+
+/**
+ * @brief Build length buckets and hashes over AT_Commands[]
+ * 
+ */
+static void AT_BuildCommandIndex(void)
+{
+    uint8_t count[AT_CMD_MAX_NAME_LEN + 1] = {0};
+    uint8_t fill[AT_CMD_MAX_NAME_LEN + 1];
+    size_t len;
+
+    for (uint8_t i = 0; i < AT_CMD_COUNT; i++)
+    {
+        len = strlen(AT_Commands[i].command);
+        if (len > AT_CMD_MAX_NAME_LEN)
+        {
+            // Prodluzte AT_CMD_MAX_NAME_LEN
+            Error_Handler();
+        }
+        count[len]++;
+        cmdHash[i] = AT_NameHash(AT_Commands[i].command, len);
+    }
+
+    cmdBucket[0] = 0;
+    for (len = 0; len <= AT_CMD_MAX_NAME_LEN; len++)
+    {
+        cmdBucket[len + 1] = cmdBucket[len] + count[len];
+        fill[len] = cmdBucket[len];
+    }
 
+    for (uint8_t i = 0; i < AT_CMD_COUNT; i++)
+    {
+        len = strlen(AT_Commands[i].command);
+        cmdIndex[fill[len]++] = i;
+    }
+}
+
+/**
+ * @brief Exact (case-insensitive) lookup of command name
+ * 
+ * @param name 
+ * @param len length of the name (without parameters)
+ * @return const AT_Command_Struct* or NULL
+ */
+static const AT_Command_Struct *AT_FindCommand(const char *name, size_t len)
+{
+    uint16_t hash;
+    uint8_t idx;
+
+    if ((len == 0) || (len > AT_CMD_MAX_NAME_LEN))
+    {
+        return NULL;
+    }
+
+    hash = AT_NameHash(name, len);
+
+    for (uint8_t i = cmdBucket[len]; i < cmdBucket[len + 1]; i++)
+    {
+        idx = cmdIndex[i];
+        if ((cmdHash[idx] == hash) && (strncasecmp(name, AT_Commands[idx].command, len) == 0))
+        {
+            return &AT_Commands[idx];
+        }
+    }
+
+    return NULL;
+}
 
 /**
  * @brief 
@@ -126,7 +281,32 @@ const AT_Command_Struct AT_Commands[] = {
  */
 void AT_Init(AT_cmd_t *p_at_Ctx)
 {   
-    at_ctx.onDataReceivedFromISR = NULL;
+    at_ctx.onDataReceived = NULL;
+    at_ctx.rxHead = 0;
+    at_ctx.rxWritten = 0;
+    at_ctx.rxEpoch = 0;
+    at_ctx.lineOverflow = false;
+    at_ctx.rxResync = false;
+    at_ctx.rxStalled = false;
+    at_ctx.rxMode = AT_RX_MODE_TEXT;
+    at_ctx.streamMaxLen = AT_STREAM_MAX_PACKET;
+    at_ctx.streamGapMs = AT_STREAM_DEFAULT_GAP_MS;
+    at_ctx.streamTxBusy = false;
+    at_ctx.streamPackets = 0;
+    at_ctx.fifoWr = 0;
+    at_ctx.fifoRd = 0;
+    at_ctx.fifoCount = 0;
+    at_ctx.fifoHighWater = 0;
+    at_ctx.fifoOverflows = 0;
+    at_ctx.droppedEvents = 0;
+    at_ctx.overflowLines = 0;
+    at_ctx.rxOverruns = 0;
+    memset(cmdFifo, 0, sizeof(cmdFifo));
+
+    AT_BuildCommandIndex();
+
+    at_ctx.txDropped = 0;
+    at_ctx.txWaits = 0;
 
     if(xUART_TXSemaphore == NULL)
     {
@@ -139,6 +319,15 @@ void AT_Init(AT_cmd_t *p_at_Ctx)
             Error_Handler();
         }
     }
+
+    if(xUART_TxSpaceSemaphore == NULL)
+    {
+        xUART_TxSpaceSemaphore = xSemaphoreCreateBinary();
+        if (xUART_TxSpaceSemaphore == NULL)
+        {
+            Error_Handler();
+        }
+    }
     
     at_ctx.sp_ctx.phuart = p_at_Ctx->sp_ctx.phuart;
     at_ctx.sp_ctx.rxStorage.raw_data = p_at_Ctx->sp_ctx.rxStorage.raw_data;
@@ -147,7 +336,7 @@ void AT_Init(AT_cmd_t *p_at_Ctx)
     at_ctx.sp_ctx.txStorage.size = p_at_Ctx->sp_ctx.txStorage.size;
 
    
-    at_ctx.onDataReceivedFromISR = p_at_Ctx->onDataReceivedFromISR;
+    at_ctx.onDataReceived = p_at_Ctx->onDataReceived;
 
     SP_PlatformInit(&at_ctx.sp_ctx);
 
@@ -155,108 +344,447 @@ void AT_Init(AT_cmd_t *p_at_Ctx)
 
 
 /**
- * @brief 
+ * @brief UART RX event (HT/TC/IDLE) - runs in ISR.
+ *        Only posts the ring write position to the main task, data are copied
+ *        and parsed in AT_HandleRxEvent() from task context.
  * 
- * @param data 
+ * @param head current DMA write position in Rx ring
  */
-static void AT_TrimEndings(char *data)
+void AT_RxEventFromISR(uint16_t head)
 {
-    size_t length = strlen(data);
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    dataQueue_t txm;
+
+    txm.cmd = CMD_MAIN_AT_RX_PACKET;
+    txm.tmp_16 = head;
+    txm.tmp_8 = at_ctx.rxEpoch;
+    txm.tmp_32 = SP_RxEventFromISR(&at_ctx.sp_ctx, head);
+    txm.ptr = NULL;
 
-    while (length > 0 && (data[length - 1] == '\n' || data[length - 1] == '\r'))
+    if (xQueueSendFromISR(queueMainHandle, &txm, &xHigherPriorityTaskWoken) != pdTRUE)
     {
-        data[length - 1] = '\0';
-        length--;
+        // Fronta je plna - data zustavaji v ringu, vycte je dalsi udalost
+        at_ctx.droppedEvents++;
     }
+
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 }
 
 /**
- * @brief 
+ * @brief UART error - runs in ISR. Restarts circular reception and lets
+ *        the main task resync the read index and report the error.
  * 
- * @param data 
  */
-void AT_HandleATCommand(uint16_t size)
-{   
-    //char *data=(char*) sp_ctx->rxStorage.raw_data;
-    char *data = (char*) at_ctx.sp_ctx.rxStorage.raw_data;
-    bool noParam = false;
-    bool isCommand = false;
+void AT_UartErrorFromISR(void)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    dataQueue_t txm;
 
-    AT_TrimEndings(data);
+    txm.cmd = CMD_MAIN_AT_UART_ERROR;
+    txm.ptr = NULL;
+    txm.tmp_bool = false;
 
-    for (uint16_t i = 0; i < sizeof(AT_Commands) / sizeof(AT_Command_Struct); i++)
-    {   
-        size_t commandLen = strlen(AT_Commands[i].command);
+    // Jen restartovany prijem (DMA od zacatku ringu) vyzaduje resync cteciho indexu
+    if (SP_HandleUARTError(&at_ctx.sp_ctx) == HAL_OK)
+    {
+        at_ctx.rxEpoch++;
+        txm.tmp_bool = true;
+    }
+    xQueueSendFromISR(queueMainHandle, &txm, &xHigherPriorityTaskWoken);
+
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+/**
+ * @brief Assemble lines from Rx ring directly into FIFO slots - main task.
+ *        A partial line stays in the write slot until the next burst. When
+ *        the FIFO is full the data wait in the Rx ring.
+ * 
+ */
+static void AT_DrainRx(void)
+{
+    AT_CmdSlot_t *slot;
+    uint16_t n;
+    bool eol;
+
+    if (SP_RxOverrun(&at_ctx.sp_ctx, at_ctx.rxWritten))
+    {
+        // DMA predbehlo cteni (plna FIFO) - obsah ringu neplati, pokracuje se od aktualni pozice
+        SP_RxSkip(&at_ctx.sp_ctx, at_ctx.rxHead, at_ctx.rxWritten);
+        at_ctx.rxOverruns++;
+        if (at_ctx.fifoCount < AT_CMD_FIFO_DEPTH)
+        {
+            cmdFifo[at_ctx.fifoWr].len = 0;
+        }
+        // Zbytek preruseneho radku / ramce zahodit az do CR/LF (0x00)
+        at_ctx.rxResync = (at_ctx.rxMode != AT_RX_MODE_STREAM);
+        at_ctx.lineOverflow = false;
+        if (at_ctx.rxMode == AT_RX_MODE_TEXT)
+        {
+            AT_SendStringResponse("ERROR - UART overrun\r\n");
+        }
+    }
 
-        if (strncasecmp(data, AT_Commands[i].command, commandLen) == 0 &&
-            (data[commandLen] == '\0' ||
-             data[commandLen] == '=' ||
-             data[commandLen] == '?'))
+    for (;;)
+    {
+        if (at_ctx.fifoCount >= AT_CMD_FIFO_DEPTH)
         {
-            char *params = data + commandLen;  // Nastavíme ukazatel za příkaz
-            isCommand = true;
-            // Pokud je tam `=`, přeskočíme znak `=`, abychom získali parametry
-            if (*params == '=')
+            if (at_ctx.rxStalled == false)
             {
-                params++;
+                at_ctx.rxStalled = true;
+                at_ctx.fifoOverflows++;
             }
-            // Pokud je tam `?`, předáme `?` jako parametr (pro `GET` příkaz)
-            else if (*params == '?')
+            return;
+        }
+        at_ctx.rxStalled = false;
+
+        slot = &cmdFifo[at_ctx.fifoWr];
+        slot->mode = at_ctx.rxMode;
+        if (slot->mode == AT_RX_MODE_STREAM)
+        {
+            // Surova data - paket se uzavre plnou velikosti nebo mezerou (AT_StreamPoll)
+            n = SP_RxRead(&at_ctx.sp_ctx, at_ctx.rxHead, (uint8_t *)&slot->line[slot->len],
+                          (uint16_t)(at_ctx.streamMaxLen - slot->len));
+            if (n == 0)
             {
-                params = "?";  // Nastavíme `params` přímo na `?`
+                return;
             }
-            else
+            if (slot->len == 0)
             {
-                // zadny parametr
-                noParam= true;
+                at_ctx.streamEscArmed = ((xTaskGetTickCount() - at_ctx.streamLastRx) >= pdMS_TO_TICKS(AT_STREAM_ESC_GUARD_MS));
             }
+            at_ctx.streamLastRx = xTaskGetTickCount();
+            slot->len += n;
 
-            if(AT_Commands[i].simpleHandler == NULL)
-            {      
-                if (noParam == true)
+            if (slot->len >= at_ctx.streamMaxLen)
+            {
+                at_ctx.fifoWr = (at_ctx.fifoWr + 1) % AT_CMD_FIFO_DEPTH;
+                at_ctx.fifoCount++;
+                if (at_ctx.fifoCount > at_ctx.fifoHighWater)
                 {
-                    AT_SendStringResponse("ERROR - Missing parameters\r\n");
-                    break;
+                    at_ctx.fifoHighWater = at_ctx.fifoCount;
                 }
+            }
+            continue;
+        }
+        else if (slot->mode == AT_RX_MODE_BINARY)
+        {
+            n = SP_RxReadFrame(&at_ctx.sp_ctx, at_ctx.rxHead, (uint8_t *)&slot->line[slot->len],
+                               (uint16_t)(sizeof(slot->line) - 1 - slot->len), &eol);
+        }
+        else
+        {
+            n = SP_RxReadLine(&at_ctx.sp_ctx, at_ctx.rxHead, (uint8_t *)&slot->line[slot->len],
+                              (uint16_t)(sizeof(slot->line) - 1 - slot->len), &eol);
+        }
+        slot->len += n;
 
-                if(at_ctx.onDataReceivedFromISR == NULL)
+        if (eol)
+        {
+            if (at_ctx.rxResync)
+            {
+                at_ctx.rxResync = false;
+                slot->len = 0;
+            }
+            else if (at_ctx.lineOverflow)
+            {
+                at_ctx.lineOverflow = false;
+                at_ctx.overflowLines++;
+                slot->len = 0;
+                if (at_ctx.rxMode == AT_RX_MODE_TEXT)
                 {
-                    AT_SendStringResponse("ERROR - No handler for this command\r\n");
-                    break;
+                    AT_SendStringResponse("ERROR - Command too long\r\n");
                 }
-                
-                if(at_ctx.onDataReceivedFromISR(params,(uint8_t) AT_Commands[i].cmdtoCore,size) == false)
+            }
+            else if (slot->len > 0)
+            {
+                slot->line[slot->len] = '\0';
+                at_ctx.fifoWr = (at_ctx.fifoWr + 1) % AT_CMD_FIFO_DEPTH;
+                at_ctx.fifoCount++;
+                if (at_ctx.fifoCount > at_ctx.fifoHighWater)
                 {
-                    AT_SendStringResponse("ERROR - Previous data was not processed yet!\r\n");
+                    at_ctx.fifoHighWater = at_ctx.fifoCount;
                 }
-                
-                //AT_Commands[i].handler(params,AT_Commands[i].cmdtoCore,size);
             }
-            else
+            // Prazdne radky (CR LF dvojice) se preskakuji
+            continue;
+        }
+
+        if (at_ctx.rxResync)
+        {
+            // Bajty pred koncem radku patri k prerusenemu prikazu
+            slot->len = 0;
+            if (n > 0)
             {
-                AT_Commands[i].simpleHandler(params);
+                continue;
             }
-            
+            return;
         }
+
+        if (slot->len >= sizeof(slot->line) - 1)
+        {
+            // Plny slot bez konce radku - zahodit az do CR/LF
+            at_ctx.lineOverflow = true;
+            slot->len = 0;
+            continue;
+        }
+
+        // Ring je prazdny
+        return;
     }
-    if(isCommand == false)
+}
+
+/**
+ * @brief Rx ring advanced - called from main task
+ * 
+ * @param head DMA write position reported by the Rx event
+ * @param epoch Rx DMA run the event belongs to
+ * @param written bytes written by DMA in this run
+ */
+void AT_HandleRxEvent(uint16_t head, uint8_t epoch, uint32_t written)
+{
+    // Udalost z predchoziho behu DMA (pred restartem) - pozice uz neplati
+    if (epoch != at_ctx.rxEpoch)
     {
-        AT_SendStringResponse("ERROR - Unknown command\r\n");
+        return;
     }
 
-    memset(data,0,size);
-    SP_RxComplete(&at_ctx.sp_ctx, size);  
-   
+    at_ctx.rxHead = head;
+    at_ctx.rxWritten = written;
+    AT_DrainRx();
 }
 
 /**
  * @brief 
  * 
+ * @return true if there is at least one complete command in FIFO
+ */
+bool AT_CommandsPending(void)
+{
+    if (at_ctx.fifoCount == 0)
+    {
+        return false;
+    }
+
+    // Stream paket ceka, dokud RF nedokonci predchozi vysilani
+    return !((cmdFifo[at_ctx.fifoRd].mode == AT_RX_MODE_STREAM) && at_ctx.streamTxBusy);
+}
+
+/**
+ * @brief How long the main task may block on its queue
+ * 
+ * @return uint32_t ticks (0 = command ready, portMAX_DELAY = nothing to time out)
+ */
+uint32_t AT_RxWaitTicks(void)
+{
+    TickType_t timeout;
+    TickType_t elapsed;
+    AT_CmdSlot_t *slot;
+
+    if (AT_CommandsPending())
+    {
+        return 0;
+    }
+
+    if ((at_ctx.rxMode != AT_RX_MODE_STREAM) || (at_ctx.fifoCount >= AT_CMD_FIFO_DEPTH))
+    {
+        return portMAX_DELAY;
+    }
+
+    slot = &cmdFifo[at_ctx.fifoWr];
+    if (slot->len == 0)
+    {
+        return portMAX_DELAY;
+    }
+
+    timeout = pdMS_TO_TICKS(at_ctx.streamGapMs);
+    if (at_ctx.streamEscArmed && (slot->len == 3) && (timeout < pdMS_TO_TICKS(AT_STREAM_ESC_GUARD_MS)))
+    {
+        // Mozny escape - rozhodne se az po guard case
+        timeout = pdMS_TO_TICKS(AT_STREAM_ESC_GUARD_MS);
+    }
+
+    elapsed = xTaskGetTickCount() - at_ctx.streamLastRx;
+    return (elapsed >= timeout) ? 0 : (timeout - elapsed);
+}
+
+/**
+ * @brief Close partial stream packet after inter-byte gap, detect "+++" escape
+ * 
  */
-void AT_HandleUartError(void)
+static void AT_StreamPoll(void)
+{
+    AT_CmdSlot_t *slot;
+    TickType_t elapsed;
+
+    if ((at_ctx.rxMode != AT_RX_MODE_STREAM) || (at_ctx.fifoCount >= AT_CMD_FIFO_DEPTH))
+    {
+        return;
+    }
+
+    slot = &cmdFifo[at_ctx.fifoWr];
+    if (slot->len == 0)
+    {
+        return;
+    }
+
+    elapsed = xTaskGetTickCount() - at_ctx.streamLastRx;
+
+    if (at_ctx.streamEscArmed && (slot->len == 3) && (memcmp(slot->line, "+++", 3) == 0))
+    {
+        if (elapsed < pdMS_TO_TICKS(AT_STREAM_ESC_GUARD_MS))
+        {
+            return;
+        }
+        // Ticho pred i po "+++" - zpet do AT modu, uz odeslane pakety dobehnou
+        AT_SetRxMode(AT_RX_MODE_TEXT);
+        AT_SendStringResponse("OK\r\n");
+        return;
+    }
+
+    if (elapsed < pdMS_TO_TICKS(at_ctx.streamGapMs))
+    {
+        return;
+    }
+
+    at_ctx.fifoWr = (at_ctx.fifoWr + 1) % AT_CMD_FIFO_DEPTH;
+    at_ctx.fifoCount++;
+    if (at_ctx.fifoCount > at_ctx.fifoHighWater)
+    {
+        at_ctx.fifoHighWater = at_ctx.fifoCount;
+    }
+}
+
+/**
+ * @brief RF finished transmitting - next stream packet may go (main task)
+ * 
+ */
+void AT_StreamTxDone(void)
+{
+    at_ctx.streamTxBusy = false;
+}
+
+/**
+ * @brief Execute the oldest queued command - called from main task
+ * 
+ */
+void AT_ProcessCommandFifo(void)
+{
+    AT_CmdSlot_t *slot;
+
+    AT_StreamPoll();
+
+    if (AT_CommandsPending() == false)
+    {
+        return;
+    }
+
+    slot = &cmdFifo[at_ctx.fifoRd];
+    if (slot->mode == AT_RX_MODE_STREAM)
+    {
+        at_ctx.streamPackets++;
+        // Pri plne TX FIFO se paket zahodi, TX done by neprisel
+        at_ctx.streamTxBusy = (GSC_SendRfPacket((uint8_t *)slot->line, (uint8_t)slot->len) != 0);
+    }
+    else if (slot->mode == AT_RX_MODE_BINARY)
+    {
+        ATB_HandleFrame((uint8_t *)slot->line, slot->len);
+    }
+    else
+    {
+        AT_HandleATCommand(slot->line);
+    }
+    slot->len = 0;
+
+    at_ctx.fifoRd = (at_ctx.fifoRd + 1) % AT_CMD_FIFO_DEPTH;
+    at_ctx.fifoCount--;
+
+    // Uvolnil se slot - docteme data, ktera cekala v ringu
+    if (at_ctx.rxStalled)
+    {
+        AT_DrainRx();
+    }
+}
+
+/**
+ * @brief Parse and dispatch one received line - called from main task
+ * 
+ * @param data zero terminated line without CR/LF
+ */
+static void AT_HandleATCommand(char *data)
 {   
-    SP_HandleUARTError(&at_ctx.sp_ctx);
-    AT_SendStringResponse("ERROR - UART error\r\n");
+    const AT_Command_Struct *cmd;
+    size_t commandLen;
+    char *params;
+
+    // Nazev prikazu konci '\0', '=' nebo '?'
+    commandLen = strcspn(data, "=?");
+
+    cmd = AT_FindCommand(data, commandLen);
+    if (cmd == NULL)
+    {
+        AT_SendStringResponse("ERROR - Unknown command\r\n");
+        return;
+    }
+
+    params = data + commandLen;  // Nastavíme ukazatel za příkaz
+    // Pokud je tam `=`, přeskočíme znak `=`, abychom získali parametry
+    if (*params == '=')
+    {
+        params++;
+    }
+    // Pokud je tam `?`, předáme `?` jako parametr (pro `GET` příkaz)
+    else if (*params == '?')
+    {
+        params = "?";  // Nastavíme `params` přímo na `?`
+    }
+    else if (cmd->simpleHandler == NULL)
+    {
+        // zadny parametr
+        AT_SendStringResponse("ERROR - Missing parameters\r\n");
+        return;
+    }
+
+    if (cmd->simpleHandler != NULL)
+    {
+        cmd->simpleHandler(params);
+        return;
+    }
+
+    if (at_ctx.onDataReceived == NULL)
+    {
+        AT_SendStringResponse("ERROR - No handler for this command\r\n");
+        return;
+    }
+
+    // Predavame jen parametry vcetne '\0', ne cely ramec
+    at_ctx.onDataReceived(params, cmd->cmdtoCore, (uint16_t)(strlen(params) + 1));
+}
+
+/**
+ * @brief Resync Rx ring after restart and report UART error - called from main task
+ * 
+ * @param rxRestarted ISR restarted reception from ring start (false = Tx error or Rx still running)
+ */
+void AT_HandleUartError(bool rxRestarted)
+{   
+    if (rxRestarted)
+    {
+        SP_RxResync(&at_ctx.sp_ctx);
+        at_ctx.rxHead = 0;
+        at_ctx.rxWritten = 0;
+        at_ctx.lineOverflow = false;
+        at_ctx.rxResync = false;
+        if (at_ctx.fifoCount < AT_CMD_FIFO_DEPTH)
+        {
+            // Rozpracovany radek zahodime
+            cmdFifo[at_ctx.fifoWr].len = 0;
+        }
+    }
+    if (at_ctx.rxMode == AT_RX_MODE_TEXT)
+    {
+        AT_SendStringResponse("ERROR - UART error\r\n");
+    }
 }
 
 /**
@@ -273,7 +801,7 @@ static  void AT_HandleFactoryReset(char *params)
     {
         AT_SendStringResponse("OK\r\n");
         AT_SendStringResponse("Factory reset complete. Rebooting...\r\n");
-        osDelay(100);  // Let message be sent
+        AT_TxFlush(500);  // Let message be sent
         NVIC_SystemReset();
     }
     else
@@ -291,75 +819,8 @@ static void AT_HandleHelp(char *params)
 {   
     UNUSED(params);
 
-    AT_SendStringResponse("\r\nSupported AT commands:\r\n");
-
-    // Základní sekce
-    AT_SendStringResponse("\r\n--- Basic ---\r\n");
-    for (uint16_t i = 0; i < sizeof(AT_Commands) / sizeof(AT_Command_Struct); i++) {
-        if (
-            strcmp(AT_Commands[i].command, "AT") == 0 ||
-            strcmp(AT_Commands[i].command, "AT+HELP") == 0 ||
-            strcmp(AT_Commands[i].command, "AT+IDENTIFY") == 0 ||
-            strcmp(AT_Commands[i].command, "AT+FACTORY_RST") == 0 ||
-            strcmp(AT_Commands[i].command, "AT+SYS_RESTART") == 0 ||
-            strcmp(AT_Commands[i].command, "AT+UART_BAUD") == 0
-        ) {
-            AT_SendStringResponse((char*)AT_Commands[i].usage);
-            if (strlen(AT_Commands[i].parameters) > 0) {
-                AT_SendStringResponse(" (Par: ");
-                AT_SendStringResponse((char*)AT_Commands[i].parameters);
-                AT_SendStringResponse(")");
-            }
-            AT_SendStringResponse("\r\n");
-        }
-    }
-
-    // LoRa sekce
-    AT_SendStringResponse("\r\n--- LoRa Radio ---\r\n");
-    for (uint16_t i = 0; i < sizeof(AT_Commands) / sizeof(AT_Command_Struct); i++) {
-        if (strstr(AT_Commands[i].command, "LR_") != NULL) {
-            AT_SendStringResponse((char*)AT_Commands[i].usage);
-            if (strlen(AT_Commands[i].parameters) > 0) {
-                AT_SendStringResponse(" (Par: ");
-                AT_SendStringResponse((char*)AT_Commands[i].parameters);
-                AT_SendStringResponse(")");
-            }
-            AT_SendStringResponse("\r\n");
-        }
-    }
-
-    // RF sekce
-    AT_SendStringResponse("\r\n--- RF ---\r\n");
-    for (uint16_t i = 0; i < sizeof(AT_Commands) / sizeof(AT_Command_Struct); i++) {
-        if (strstr(AT_Commands[i].command, "RF_") != NULL) {
-            AT_SendStringResponse((char*)AT_Commands[i].usage);
-            if (strlen(AT_Commands[i].parameters) > 0) {
-                AT_SendStringResponse(" (Par: ");
-                AT_SendStringResponse((char*)AT_Commands[i].parameters);
-                AT_SendStringResponse(")");
-            }
-            AT_SendStringResponse("\r\n");
-        }
-    }
-
-    // AUX sekce
-    AT_SendStringResponse("\r\n--- AUX GPIO ---\r\n");
-    for (uint16_t i = 0; i < sizeof(AT_Commands) / sizeof(AT_Command_Struct); i++) {
-        if (strstr(AT_Commands[i].command, "AUX") != NULL) {
-            AT_SendStringResponse((char*)AT_Commands[i].usage);
-            if (strlen(AT_Commands[i].parameters) > 0) {
-                AT_SendStringResponse(" (Par: ");
-                AT_SendStringResponse((char*)AT_Commands[i].parameters);
-                AT_SendStringResponse(")");
-            }
-            AT_SendStringResponse("\r\n");
-        }
-    }
-
-    // Add examples for complex commands
-    AT_SendStringResponse("\r\nExamples for complex commands:\r\n");
-    AT_SendStringResponse("  AT+LR_TX_SET=SF:9,BW:7,CR:45,Freq:869525000,IQInv:0,HeaderMode:0,CRC:1,Preamble:8,Power:22,LDRO:2\r\n");
-    AT_SendStringResponse("  AT+LR_RX_SET=SF:9,BW:7,CR:45,Freq:869525000,IQInv:0,HeaderMode:0,CRC:1,Preamble:8,LDRO:2\r\n");
+    // Zadne skladani ani cekani - blob z flash jde primo do DMA
+    AT_SendConst((const uint8_t *)AT_HelpText, (uint16_t)(sizeof(AT_HelpText) - 1));
 }
 
 /**
@@ -403,6 +864,213 @@ static void AT_HandleRestartSys(char *params)
 }
 
 
+/**
+ * @brief Switch UART baud rate in place - main task context.
+ *        Drains Tx, reconfigures USART1, restarts Rx and confirms
+ *        with "+BAUD:<rate>" at the rate actually in use (old one on failure).
+ * 
+ * @param baud 
+ * @return true switched to baud
+ * @return false old rate stays
+ */
+bool AT_ChangeBaudRate(uint32_t baud)
+{
+    char confirm[24];
+    uint32_t oldBaud = at_ctx.sp_ctx.phuart->Init.BaudRate;
+    HAL_StatusTypeDef ret;
+    bool switched = false;
+
+    // Vse odeslane (vcetne OK) musi odejit jeste starou rychlosti
+    if (AT_TxFlush(AT_BAUD_FLUSH_TIMEOUT_MS))
+    {
+        ret = SP_ChangeBaudRate(&at_ctx.sp_ctx, baud);
+        switched = (ret == HAL_OK);
+        if (ret == HAL_ERROR)
+        {
+            // Prijem uz byl zastaven - zpet na puvodni rychlost
+            if (SP_ChangeBaudRate(&at_ctx.sp_ctx, oldBaud) != HAL_OK)
+            {
+                _exit(8001);
+            }
+        }
+        if (ret != HAL_BUSY)
+        {
+            AT_RxRestarted();
+        }
+    }
+
+    osDelay(AT_BAUD_CONFIRM_DELAY_MS);
+    snprintf(confirm, sizeof(confirm), "+BAUD:%lu\r\n", (unsigned long)at_ctx.sp_ctx.phuart->Init.BaudRate);
+    AT_SendStringResponse(confirm);
+
+    return switched;
+}
+
+/**
+ * @brief Rx DMA was restarted from ring start by the task - drop old events and partial line
+ * 
+ */
+static void AT_RxRestarted(void)
+{
+    // Rx DMA bezi od zacatku ringu - stare udalosti a rozpracovany radek zahodit
+    at_ctx.rxEpoch++;
+    at_ctx.rxHead = 0;
+    at_ctx.rxWritten = 0;
+    at_ctx.lineOverflow = false;
+    at_ctx.rxResync = false;
+    if (at_ctx.fifoCount < AT_CMD_FIFO_DEPTH)
+    {
+        cmdFifo[at_ctx.fifoWr].len = 0;
+    }
+}
+
+/**
+ * @brief AT+BIN_MODE - switch Rx/Tx to binary COBS protocol
+ * 
+ * @param params 
+ */
+static void AT_HandleBinMode(char *params)
+{
+    if (strcmp(params, "?") == 0)
+    {
+        AT_SendStringResponse((at_ctx.rxMode == AT_RX_MODE_BINARY) ? "+BIN_MODE:1\r\n" : "+BIN_MODE:0\r\n");
+    }
+    else if (strcmp(params, "1") == 0)
+    {
+        // OK jeste v textovem rezimu, dalsi data uz jako COBS ramce
+        AT_SendStringResponse("OK\r\n");
+        AT_SetBinaryMode(true);
+    }
+    else if (strcmp(params, "0") == 0)
+    {
+        AT_SendStringResponse("OK\r\n");
+    }
+    else
+    {
+        AT_SendStringResponse("ERROR - Invalid parameter\r\n");
+    }
+}
+
+/**
+ * @brief AT+UART_STAT? - UART Rx/Tx path statistics
+ * 
+ * @param params 
+ */
+static void AT_HandleUartStat(char *params)
+{
+    char response[96];
+
+    if (strcmp(params, "?") != 0)
+    {
+        AT_SendStringResponse("ERROR - Invalid parameter\r\n");
+        return;
+    }
+
+    snprintf(response, sizeof(response), "+UART_STAT:%u,%lu,%lu,%lu,%lu,%u,%lu,%lu\r\n",
+             at_ctx.fifoHighWater, (unsigned long)at_ctx.fifoOverflows, (unsigned long)at_ctx.droppedEvents,
+             (unsigned long)at_ctx.overflowLines, (unsigned long)at_ctx.rxOverruns,
+             at_ctx.sp_ctx.txHighWater, (unsigned long)at_ctx.txWaits, (unsigned long)at_ctx.txDropped);
+    AT_SendStringResponse(response);
+}
+
+/**
+ * @brief AT+STREAM - transparent mode, raw UART bytes are sent as RF packets
+ * 
+ * @param params 
+ */
+static void AT_HandleStream(char *params)
+{
+    char response[32];
+    char *gapStr;
+    long maxLen;
+    long gapMs = AT_STREAM_DEFAULT_GAP_MS;
+    char *end;
+
+    if (strcmp(params, "?") == 0)
+    {
+        snprintf(response, sizeof(response), "+STREAM:%u,%u\r\n", at_ctx.streamMaxLen, at_ctx.streamGapMs);
+        AT_SendStringResponse(response);
+        return;
+    }
+
+    gapStr = strchr(params, ',');
+    if (gapStr != NULL)
+    {
+        *gapStr++ = '\0';
+        gapMs = strtol(gapStr, &end, 10);
+        if ((end == gapStr) || (*end != '\0') || (gapMs < 1) || (gapMs > AT_STREAM_MAX_GAP_MS))
+        {
+            AT_SendStringResponse("ERROR - Invalid gap, use 1-10000 ms\r\n");
+            return;
+        }
+    }
+
+    maxLen = strtol(params, &end, 10);
+    if ((end == params) || (*end != '\0') || (maxLen < 1) || (maxLen > AT_STREAM_MAX_PACKET))
+    {
+        AT_SendStringResponse("ERROR - Invalid max length, use 1-255\r\n");
+        return;
+    }
+
+    at_ctx.streamMaxLen = (uint16_t)maxLen;
+    at_ctx.streamGapMs = (uint16_t)gapMs;
+
+    // OK jeste v AT modu, dalsi bajty uz jdou do RF
+    AT_SendStringResponse("OK\r\n");
+    AT_SetRxMode(AT_RX_MODE_STREAM);
+}
+
+/**
+ * @brief Switch Rx assembling mode - main task context
+ * 
+ * @param mode 
+ */
+static void AT_SetRxMode(AT_RxMode_e mode)
+{
+    at_ctx.rxMode = (uint8_t)mode;
+    at_ctx.lineOverflow = false;
+    at_ctx.rxResync = false;
+    at_ctx.streamLastRx = xTaskGetTickCount();
+    at_ctx.streamEscArmed = false;
+
+    // Rozpracovany radek / ramec ze stareho rezimu zahodime
+    if (at_ctx.fifoCount < AT_CMD_FIFO_DEPTH)
+    {
+        cmdFifo[at_ctx.fifoWr].len = 0;
+    }
+}
+
+/**
+ * @brief Switch between AT text and binary protocol - main task context
+ * 
+ * @param enable 
+ */
+void AT_SetBinaryMode(bool enable)
+{
+    AT_SetRxMode(enable ? AT_RX_MODE_BINARY : AT_RX_MODE_TEXT);
+}
+
+/**
+ * @brief 
+ * 
+ * @return true if binary protocol is active
+ */
+bool AT_IsBinaryMode(void)
+{
+    return (at_ctx.rxMode == AT_RX_MODE_BINARY);
+}
+
+/**
+ * @brief 
+ * 
+ * @return true if transparent stream mode is active
+ */
+bool AT_IsStreamMode(void)
+{
+    return (at_ctx.rxMode == AT_RX_MODE_STREAM);
+}
+
+
 /**
  * @brief 
  * 
@@ -410,29 +1078,274 @@ static void AT_HandleRestartSys(char *params)
  */
 void AT_SendStringResponse(char *response)
 {   
+    AT_SendData((const uint8_t *)response, (uint16_t)strlen(response));
+}
+
+/**
+ * @brief Enqueue data into DMA Tx ring and return. From a task it waits only
+ *        while the ring is full, from ISR whatever does not fit is dropped.
+ * 
+ * @param data 
+ * @param len 
+ */
+void AT_SendData(const uint8_t *data, uint16_t len)
+{
     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    uint16_t n;
 
     if (__get_IPSR())  
     {
         // Použití semaforu z ISR
         if (xSemaphoreTakeFromISR(xUART_TXSemaphore, &xHigherPriorityTaskWoken) == pdTRUE)
         {
-         //   HAL_UART_Transmit_DMA(&huart1, (uint8_t *)response, strlen(response));
-            HAL_UART_Transmit(&huart1, (uint8_t *)response, strlen(response),HAL_MAX_DELAY);
+            if (SP_TxWrite(&at_ctx.sp_ctx, data, len) < len)
+            {
+                at_ctx.txDropped++;
+            }
             xSemaphoreGiveFromISR(xUART_TXSemaphore, &xHigherPriorityTaskWoken);
-            // Uvolníme semafor při dokončení přenosu (v přerušení)
             portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
         }
+        else
+        {
+            // Tx zamek drzi task - ISR nemuze cekat, odpoved se zahodi cela
+            at_ctx.txDropped++;
+        }
     }
     else
     {
         if (xSemaphoreTake(xUART_TXSemaphore, portMAX_DELAY) == pdTRUE)
         {
-            HAL_UART_Transmit(&huart1, (uint8_t *)response, strlen(response),HAL_MAX_DELAY);
+            for (;;)
+            {
+                n = SP_TxWrite(&at_ctx.sp_ctx, data, len);
+                data += n;
+                len -= n;
+
+                if (len == 0)
+                {
+                    break;
+                }
+
+                // Ring je plny - pockame, az DMA dokonci blok
+                at_ctx.txWaits++;
+                if (xSemaphoreTake(xUART_TxSpaceSemaphore, pdMS_TO_TICKS(AT_TX_WAIT_TIMEOUT_MS)) != pdTRUE)
+                {
+                    at_ctx.txDropped++;
+                    break;
+                }
+            }
             xSemaphoreGive(xUART_TXSemaphore);
         }
     }
+}
+
+/**
+ * @brief Reserve maxLen bytes in Tx ring for formatting a response in place
+ *        (no stack buffer, no copy) - task context only. Holds the Tx lock
+ *        until AT_TxEnd, waits while the ring is full.
+ * 
+ * @param wr 
+ * @param maxLen upper bound of the response length
+ * @return true 
+ * @return false no space within AT_TX_WAIT_TIMEOUT_MS - do not call AT_TxEnd
+ */
+bool AT_TxBegin(AT_TxWriter_t *wr, uint16_t maxLen)
+{
+    if (__get_IPSR() || (maxLen >= at_ctx.sp_ctx.txStorage.size))
+    {
+        at_ctx.txDropped++;
+        return false;
+    }
+
+    if (xSemaphoreTake(xUART_TXSemaphore, portMAX_DELAY) != pdTRUE)
+    {
+        return false;
+    }
+
+    while (SP_TxReserve(&at_ctx.sp_ctx, &wr->span) < maxLen)
+    {
+        // Ring je plny - pockame, az DMA dokonci blok
+        at_ctx.txWaits++;
+        if (xSemaphoreTake(xUART_TxSpaceSemaphore, pdMS_TO_TICKS(AT_TX_WAIT_TIMEOUT_MS)) != pdTRUE)
+        {
+            at_ctx.txDropped++;
+            xSemaphoreGive(xUART_TXSemaphore);
+            return false;
+        }
+    }
+
+    wr->pos = 0;
+    wr->maxLen = maxLen;
+    return true;
+}
+
+/**
+ * @brief 
+ * 
+ * @param wr 
+ * @param byte 
+ */
+static inline void AT_TxPutByte(AT_TxWriter_t *wr, uint8_t byte)
+{
+    if (wr->pos < wr->span.partLen[0])
+    {
+        wr->span.part[0][wr->pos] = byte;
+    }
+    else
+    {
+        wr->span.part[1][wr->pos - wr->span.partLen[0]] = byte;
+    }
+    wr->pos++;
+}
 
-    //TODOJR DMA
-    //HAL_UART_Transmit(&huart1, (uint8_t *)response, strlen(response),0xFFFF);
+/**
+ * @brief 
+ * 
+ * @param wr 
+ * @param data 
+ * @param len 
+ */
+void AT_TxPut(AT_TxWriter_t *wr, const uint8_t *data, uint16_t len)
+{
+    if (len > (uint16_t)(wr->maxLen - wr->pos))
+    {
+        len = (uint16_t)(wr->maxLen - wr->pos);
+    }
+    for (uint16_t i = 0; i < len; i++)
+    {
+        AT_TxPutByte(wr, data[i]);
+    }
+}
+
+/**
+ * @brief Two upper-case HEX digits per byte
+ * 
+ * @param wr 
+ * @param data 
+ * @param len 
+ */
+void AT_TxPutHex(AT_TxWriter_t *wr, const uint8_t *data, uint16_t len)
+{
+    static const char hex_digits[] = "0123456789ABCDEF";
+
+    if (len > (uint16_t)((wr->maxLen - wr->pos) / 2))
+    {
+        len = (uint16_t)((wr->maxLen - wr->pos) / 2);
+    }
+    for (uint16_t i = 0; i < len; i++)
+    {
+        AT_TxPutByte(wr, (uint8_t)hex_digits[data[i] >> 4]);
+        AT_TxPutByte(wr, (uint8_t)hex_digits[data[i] & 0x0F]);
+    }
+}
+
+/**
+ * @brief Printable ASCII (32-126) as is, other bytes as '.'
+ * 
+ * @param wr 
+ * @param data 
+ * @param len 
+ */
+void AT_TxPutPrintable(AT_TxWriter_t *wr, const uint8_t *data, uint16_t len)
+{
+    if (len > (uint16_t)(wr->maxLen - wr->pos))
+    {
+        len = (uint16_t)(wr->maxLen - wr->pos);
+    }
+    for (uint16_t i = 0; i < len; i++)
+    {
+        AT_TxPutByte(wr, ((data[i] >= 32) && (data[i] <= 126)) ? data[i] : (uint8_t)'.');
+    }
+}
+
+/**
+ * @brief Send what was written since AT_TxBegin and release the Tx lock
+ * 
+ * @param wr 
+ */
+void AT_TxEnd(AT_TxWriter_t *wr)
+{
+    SP_TxCommit(&at_ctx.sp_ctx, wr->pos);
+    xSemaphoreGive(xUART_TXSemaphore);
+}
+
+/**
+ * @brief Send a const (flash) block straight by DMA, without copying it through
+ *        the Tx ring - task context. Waits only while a previous const block
+ *        is still pending.
+ * 
+ * @param data must stay valid until sent (const data in flash)
+ * @param len 
+ */
+void AT_SendConst(const uint8_t *data, uint16_t len)
+{
+    if (xSemaphoreTake(xUART_TXSemaphore, portMAX_DELAY) == pdTRUE)
+    {
+        while (SP_TxWriteConst(&at_ctx.sp_ctx, data, len) == false)
+        {
+            at_ctx.txWaits++;
+            if (xSemaphoreTake(xUART_TxSpaceSemaphore, pdMS_TO_TICKS(AT_TX_WAIT_TIMEOUT_MS)) != pdTRUE)
+            {
+                at_ctx.txDropped++;
+                break;
+            }
+        }
+        xSemaphoreGive(xUART_TXSemaphore);
+    }
+}
+
+/**
+ * @brief DMA Tx chunk complete - runs in ISR
+ * 
+ */
+void AT_TxCompleteFromISR(void)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    SP_TxCompleteFromISR(&at_ctx.sp_ctx);
+    xSemaphoreGiveFromISR(xUART_TxSpaceSemaphore, &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+/**
+ * @brief 
+ * 
+ * @return true if Tx path goes through DMA ring (AT layer initialized, scheduler running)
+ */
+bool AT_TxReady(void)
+{
+    return (xUART_TxSpaceSemaphore != NULL) &&
+           (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING);
+}
+
+/**
+ * @brief Wait until everything queued was sent (e.g. before reset or baud change)
+ * 
+ * @param timeoutMs 
+ * @return true 
+ * @return false on timeout
+ */
+bool AT_TxFlush(uint32_t timeoutMs)
+{
+    TickType_t start = xTaskGetTickCount();
+
+    while (SP_TxIdle(&at_ctx.sp_ctx) == false)
+    {
+        if ((xTaskGetTickCount() - start) >= pdMS_TO_TICKS(timeoutMs))
+        {
+            return false;
+        }
+        osDelay(1);
+    }
+
+    // Posledni bajt jeste muze byt v shift registru (max. 1 znak, i pri 9600 Bd ~1 ms)
+    while (__HAL_UART_GET_FLAG(at_ctx.sp_ctx.phuart, UART_FLAG_TC) == RESET)
+    {
+        if ((xTaskGetTickCount() - start) >= pdMS_TO_TICKS(timeoutMs))
+        {
+            return false;
+        }
+        osDelay(1);
+    }
+    return true;
 }
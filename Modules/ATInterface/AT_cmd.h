@@ -75,10 +75,78 @@ typedef enum
     SYS_CMD_RX_PLDLEN       = 47,
     SYS_CMD_UART_BAUD       = 48,
     SYS_CMD_RX_FORMAT       = 49,
+    SYS_CMD_RF_RX_STAT      = 52,
+    SYS_CMD_RF_TX_LBT       = 53,
+    SYS_CMD_RF_LBT_CFG      = 54,
+    SYS_CMD_RF_LBT_STAT     = 55,
+    SYS_CMD_RX_SNIFF        = 56,
+    SYS_CMD_RF_TX_LRFHSS    = 57,
+    SYS_CMD_LRFHSS_CR       = 58,
+    SYS_CMD_LRFHSS_BW       = 59,
+    SYS_CMD_LRFHSS_HOPSEQ   = 60,
+    SYS_CMD_LRFHSS_SYNC     = 61,
+    SYS_CMD_RF_MODEM        = 62,
+    SYS_CMD_GFSK_BITRATE    = 63,
+    SYS_CMD_GFSK_FDEV       = 64,
+    SYS_CMD_GFSK_BW         = 65,
+    SYS_CMD_GFSK_PREAMBLE   = 66,
+    SYS_CMD_GFSK_CRC        = 67,
+    SYS_CMD_GFSK_WHITENING  = 68,
+    SYS_CMD_GFSK_SYNC       = 69,
+    SYS_CMD_RF_TX_SCHED     = 70,
+    SYS_CMD_RF_SCHED_STAT   = 71,
+    SYS_CMD_RF_POOL_STAT    = 72,
+    SYS_CMD_RF_BUSY_STAT    = 73,
+    SYS_CMD_RF_SPI_STAT     = 74,
 
 } eATCommands;
 
 
+/* Command FIFO - lines are assembled directly into static slots and executed
+   by the main task one by one, so bursts are queued instead of rejected */
+#ifndef AT_CMD_FIFO_DEPTH
+#define AT_CMD_FIFO_DEPTH   3
+#endif
+#define AT_CMD_SLOT_SIZE    MAX_UART_RX_BUFFER
+
+/* Max. wait for free space in Tx ring before the rest of a response is dropped */
+#define AT_TX_WAIT_TIMEOUT_MS   200
+
+/* Time for the host to switch its port before "+BAUD" confirmation at the new rate */
+#define AT_BAUD_CONFIRM_DELAY_MS    50
+#define AT_BAUD_FLUSH_TIMEOUT_MS    500     // odeslani Tx ringu pred prepnutim rychlosti
+
+/* Transparent stream mode (AT+STREAM) - raw UART bytes are cut into RF packets
+   by max. size or inter-byte gap, "+++" surrounded by guard silence returns to AT */
+#define AT_STREAM_MAX_PACKET        255
+#define AT_STREAM_DEFAULT_GAP_MS    20
+#define AT_STREAM_MAX_GAP_MS        10000
+#define AT_STREAM_ESC_GUARD_MS      500
+
+/**
+ * @brief What the Rx path assembles from UART bytes
+ * 
+ */
+typedef enum
+{
+    AT_RX_MODE_TEXT     = 0,            // AT radky ukoncene CR/LF
+    AT_RX_MODE_BINARY   = 1,            // COBS ramce (AT_binary.c)
+    AT_RX_MODE_STREAM   = 2,            // surova data -> RF pakety
+
+} AT_RxMode_e;
+
+/**
+ * @brief One command slot (zero terminated line without CR/LF)
+ * 
+ */
+typedef struct
+{
+    char line[AT_CMD_SLOT_SIZE];
+    uint16_t len;
+    uint8_t mode;                       // AT_RxMode_e, ve kterem byl slot slozen
+
+} AT_CmdSlot_t;
+
 /**
  * @brief 
  * 
@@ -86,13 +154,68 @@ typedef enum
 typedef struct AT_cmd
 {
     SP_Context_t sp_ctx;
-    bool (*onDataReceivedFromISR)(char *params, eATCommands cmdToCore, uint16_t size); 
+    void (*onDataReceived)(char *params, eATCommands cmdToCore, uint16_t size);     // volano z kontextu tasku
+    uint16_t rxHead;                    // posledni zapisova pozice DMA v Rx ringu
+    uint32_t rxWritten;                 // bajty zapsane DMA do ringu k posledni udalosti (detekce predbehnuti)
+    volatile uint8_t rxEpoch;           // zvysi se pri kazdem restartu Rx DMA - starsi udalosti se ignoruji
+    bool lineOverflow;                  // radek delsi nez slot - zahodit do CR/LF
+    bool rxResync;                      // po overrunu Rx ringu - zahodit do CR/LF bez dalsi chyby
+    bool rxStalled;                     // FIFO plna - data cekaji v Rx ringu
+    uint8_t rxMode;                     // AT_RxMode_e
+    uint8_t fifoWr;                     // slot, do ktereho se sklada radek
+    uint8_t fifoRd;                     // nejstarsi prikaz k provedeni
+    uint8_t fifoCount;                  // pocet kompletnich prikazu ve FIFO
+    uint8_t fifoHighWater;
+    uint32_t fifoOverflows;             // kolikrat byla FIFO plna
+    volatile uint32_t droppedEvents;    // Rx udalosti zahozene v ISR (plna fronta main tasku)
+    uint32_t overflowLines;
+    uint32_t rxOverruns;                // DMA prepsalo neprectena data v Rx ringu
+    uint32_t txWaits;                   // kolikrat musel zapis cekat na misto v Tx ringu
+    uint32_t txDropped;                 // odpovedi (nebo jejich casti) zahozene pri plnem Tx ringu / zamku z ISR
+    uint16_t streamMaxLen;              // max. velikost RF paketu ve stream modu
+    uint16_t streamGapMs;               // mezera na UART, po ktere se paket odesle
+    uint32_t streamLastRx;              // tick posledni Rx davky ve stream modu
+    bool streamEscArmed;                // pred aktualnim paketem bylo ticho >= guard ("+++" muze byt escape)
+    bool streamTxBusy;                  // paket ceka na RF TX done - dalsi se posila az potom
+    uint32_t streamPackets;
 
 } __attribute__((packed)) AT_cmd_t;
 
+/**
+ * @brief Response formatted in place in the Tx ring (AT_TxBegin .. AT_TxEnd)
+ * 
+ */
+typedef struct
+{
+    SP_TxSpan_t span;
+    uint16_t pos;                       // zapsano bajtu
+    uint16_t maxLen;                    // rezervovano v AT_TxBegin
+
+} AT_TxWriter_t;
+
 void AT_SendStringResponse(char *response);
-void AT_HandleATCommand(uint16_t size);
-void AT_HandleUartError(void);
+void AT_SendData(const uint8_t *data, uint16_t len);
+void AT_SendConst(const uint8_t *data, uint16_t len);
+bool AT_TxBegin(AT_TxWriter_t *wr, uint16_t maxLen);
+void AT_TxPut(AT_TxWriter_t *wr, const uint8_t *data, uint16_t len);
+void AT_TxPutHex(AT_TxWriter_t *wr, const uint8_t *data, uint16_t len);
+void AT_TxPutPrintable(AT_TxWriter_t *wr, const uint8_t *data, uint16_t len);
+void AT_TxEnd(AT_TxWriter_t *wr);
+void AT_TxCompleteFromISR(void);
+bool AT_TxReady(void);
+bool AT_TxFlush(uint32_t timeoutMs);
+bool AT_ChangeBaudRate(uint32_t baud);
+void AT_SetBinaryMode(bool enable);
+bool AT_IsBinaryMode(void);
+bool AT_IsStreamMode(void);
+void AT_StreamTxDone(void);
+uint32_t AT_RxWaitTicks(void);
+void AT_HandleRxEvent(uint16_t head, uint8_t epoch, uint32_t written);
+bool AT_CommandsPending(void);
+void AT_ProcessCommandFifo(void);
+void AT_HandleUartError(bool rxRestarted);
+void AT_RxEventFromISR(uint16_t head);
+void AT_UartErrorFromISR(void);
 void AT_Init(AT_cmd_t *atCmd);
 
 #endif // AT_CMD_H
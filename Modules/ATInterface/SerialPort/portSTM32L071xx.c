@@ -10,6 +10,7 @@
  */
 #include "main.h"
 #include "portSTM32L071xx.h"
+#include <string.h>
 
 
 #define LOG_TAG "[sPort:]"
@@ -21,6 +22,9 @@
 /*      S T A T I C   F U N C T I O N   P R O T O T Y P E       */
 /****************************************************************/
 static HAL_StatusTypeDef SP_StartRecToIdle_DMA(UART_HandleTypeDef *huart, void *pData, uint16_t Size);
+static HAL_StatusTypeDef SP_RxStart(SP_Context_t *sp_ctx);
+static void SP_TxKick(SP_Context_t *sp_ctx);
+static uint16_t SP_RxReadDelimited(SP_Context_t *sp_ctx, uint16_t head, uint8_t *dst, uint16_t maxLen, bool binary, bool *end);
 
 /****************************************************************/
 /*            F U N C T I O N   D E F I N I T I O N             */
@@ -40,12 +44,38 @@ bool SP_PlatformInit(SP_Context_t *sp_ctx)
 		return false;
 	}
 	
+	sp_ctx->rxTail = 0;
+	sp_ctx->rxRead = 0;
+	sp_ctx->txHead = 0;
+	sp_ctx->txTail = 0;
+	sp_ctx->txDmaLen = 0;
+	sp_ctx->txHighWater = 0;
+	sp_ctx->txExtData = NULL;
+	sp_ctx->txExtLen = 0;
+	sp_ctx->txExtAt = 0;
+	sp_ctx->txExtActive = false;
+	return SP_RxStart(sp_ctx);
+}
+
+
+/**
+ * @brief (Re)start circular Rx DMA from ring start and reset the DMA write counter -
+ *        ISR context or with Rx events not running
+ * 
+ * @param sp_ctx 
+ * @return HAL_StatusTypeDef 
+ */
+static HAL_StatusTypeDef SP_RxStart(SP_Context_t *sp_ctx)
+{
+	sp_ctx->rxIsrHead = 0;
+	sp_ctx->rxWritten = 0;
 	return SP_StartRecToIdle_DMA(sp_ctx->phuart, sp_ctx->rxStorage.raw_data, sp_ctx->rxStorage.size);
 }
 
 
 /**
- * @brief 
+ * @brief Start circular DMA reception into the Rx ring. DMA runs forever,
+ *        HT/TC/IDLE events only report the current write position.
  * 
  * @param huart 
  * @param pData 
@@ -57,7 +87,6 @@ HAL_StatusTypeDef SP_StartRecToIdle_DMA(UART_HandleTypeDef *huart, void *pData,
 	__HAL_UART_CLEAR_FLAG(huart, 0xFFFFFFFF);
 	if (HAL_UARTEx_ReceiveToIdle_DMA(huart, pData, Size) == HAL_OK)
 	{
-		__HAL_DMA_DISABLE_IT(huart->hdmarx, DMA_IT_HT);
 		return HAL_OK;
 	}
 	else
@@ -66,7 +95,6 @@ HAL_StatusTypeDef SP_StartRecToIdle_DMA(UART_HandleTypeDef *huart, void *pData,
 		HAL_UART_AbortReceive(huart);
 		if (HAL_UARTEx_ReceiveToIdle_DMA(huart, pData, Size) == HAL_OK)
 		{
-			__HAL_DMA_DISABLE_IT(huart->hdmarx, DMA_IT_HT);
 			return HAL_OK;
 		}
 		else
@@ -78,18 +106,192 @@ HAL_StatusTypeDef SP_StartRecToIdle_DMA(UART_HandleTypeDef *huart, void *pData,
 
 
 /**
- * @brief 
+ * @brief Copy bytes from Rx ring (tail -> head) into linear buffer - task context
  * 
  * @param sp_ctx 
- * @param size 
- * @return true 
- * @return false 
+ * @param head write position reported by the Rx event (Size from HAL callback)
+ * @param dst 
+ * @param maxLen 
+ * @return uint16_t number of copied bytes, remaining bytes stay in the ring
  */
-bool SP_RxComplete(SP_Context_t *sp_ctx, uint16_t size)
-{	
-	UNUSED(size);
-	HAL_StatusTypeDef ret = SP_StartRecToIdle_DMA(sp_ctx->phuart, sp_ctx->rxStorage.raw_data, sp_ctx->rxStorage.size);
-	return (ret == HAL_OK) ? true : false;
+uint16_t SP_RxRead(SP_Context_t *sp_ctx, uint16_t head, uint8_t *dst, uint16_t maxLen)
+{
+	uint16_t ringSize = sp_ctx->rxStorage.size;
+	uint16_t tail = sp_ctx->rxTail;
+	uint16_t count = 0;
+
+	// TC event reports Size == ring size -> DMA already wrapped to 0
+	if (head >= ringSize)
+	{
+		head = 0;
+	}
+
+	while ((tail != head) && (count < maxLen))
+	{
+		uint16_t chunk = (head > tail) ? (uint16_t)(head - tail) : (uint16_t)(ringSize - tail);
+
+		if (chunk > (maxLen - count))
+		{
+			chunk = maxLen - count;
+		}
+
+		memcpy(&dst[count], &sp_ctx->rxStorage.raw_data[tail], chunk);
+		count += chunk;
+		tail += chunk;
+
+		if (tail >= ringSize)
+		{
+			tail = 0;
+		}
+	}
+
+	sp_ctx->rxTail = tail;
+	sp_ctx->rxRead += count;
+	return count;
+}
+
+
+/**
+ * @brief Copy bytes from Rx ring into dst until a delimiter - task context.
+ *        Stops at delimiter (consumed, not copied), at maxLen or when ring is empty.
+ * 
+ * @param sp_ctx 
+ * @param head write position reported by the Rx event
+ * @param dst 
+ * @param maxLen 
+ * @param binary false = text line (CR or LF), true = COBS frame (0x00)
+ * @param end set to true if delimiter was found
+ * @return uint16_t number of copied bytes
+ */
+static uint16_t SP_RxReadDelimited(SP_Context_t *sp_ctx, uint16_t head, uint8_t *dst, uint16_t maxLen, bool binary, bool *end)
+{
+	uint16_t ringSize = sp_ctx->rxStorage.size;
+	uint16_t tail = sp_ctx->rxTail;
+	uint16_t count = 0;
+	uint8_t byte;
+
+	*end = false;
+
+	if (head >= ringSize)
+	{
+		head = 0;
+	}
+
+	while ((tail != head) && (count < maxLen))
+	{
+		byte = sp_ctx->rxStorage.raw_data[tail];
+		sp_ctx->rxRead++;
+
+		if (++tail >= ringSize)
+		{
+			tail = 0;
+		}
+
+		if (binary ? (byte == 0x00) : ((byte == '\r') || (byte == '\n')))
+		{
+			*end = true;
+			break;
+		}
+
+		dst[count++] = byte;
+	}
+
+	sp_ctx->rxTail = tail;
+	return count;
+}
+
+
+/**
+ * @brief Copy one text line from Rx ring (CR/LF terminated)
+ * 
+ * @param sp_ctx 
+ * @param head 
+ * @param dst 
+ * @param maxLen 
+ * @param eol set to true if line terminator was found
+ * @return uint16_t number of copied bytes
+ */
+uint16_t SP_RxReadLine(SP_Context_t *sp_ctx, uint16_t head, uint8_t *dst, uint16_t maxLen, bool *eol)
+{
+	return SP_RxReadDelimited(sp_ctx, head, dst, maxLen, false, eol);
+}
+
+
+/**
+ * @brief Copy one COBS frame from Rx ring (0x00 terminated)
+ * 
+ * @param sp_ctx 
+ * @param head 
+ * @param dst 
+ * @param maxLen 
+ * @param eof set to true if frame delimiter was found
+ * @return uint16_t number of copied bytes
+ */
+uint16_t SP_RxReadFrame(SP_Context_t *sp_ctx, uint16_t head, uint8_t *dst, uint16_t maxLen, bool *eof)
+{
+	return SP_RxReadDelimited(sp_ctx, head, dst, maxLen, true, eof);
+}
+
+
+/**
+ * @brief Reset read index after reception was restarted (UART error) - task context
+ * 
+ * @param sp_ctx 
+ */
+void SP_RxResync(SP_Context_t *sp_ctx)
+{
+	sp_ctx->rxTail = 0;
+	sp_ctx->rxRead = 0;
+}
+
+
+/**
+ * @brief Account bytes written by DMA since the previous Rx event - ISR context.
+ *        HT/TC events come every half ring, so DMA can not lap between two events.
+ * 
+ * @param sp_ctx 
+ * @param head write position reported by the Rx event
+ * @return uint32_t bytes written by DMA since reception start
+ */
+uint32_t SP_RxEventFromISR(SP_Context_t *sp_ctx, uint16_t head)
+{
+	uint16_t ringSize = sp_ctx->rxStorage.size;
+
+	if (head >= ringSize)
+	{
+		head = 0;
+	}
+
+	sp_ctx->rxWritten += (uint16_t)((head + ringSize - sp_ctx->rxIsrHead) % ringSize);
+	sp_ctx->rxIsrHead = head;
+	return sp_ctx->rxWritten;
+}
+
+
+/**
+ * @brief DMA overwrote data not read yet - task context
+ * 
+ * @param sp_ctx 
+ * @param written DMA byte counter from SP_RxEventFromISR
+ * @return true unread data in the ring are no longer valid
+ */
+bool SP_RxOverrun(SP_Context_t *sp_ctx, uint32_t written)
+{
+	return (uint32_t)(written - sp_ctx->rxRead) > sp_ctx->rxStorage.size;
+}
+
+
+/**
+ * @brief Drop everything in the Rx ring up to the DMA write position (after overrun) - task context
+ * 
+ * @param sp_ctx 
+ * @param head 
+ * @param written 
+ */
+void SP_RxSkip(SP_Context_t *sp_ctx, uint16_t head, uint32_t written)
+{
+	sp_ctx->rxTail = (head >= sp_ctx->rxStorage.size) ? 0 : head;
+	sp_ctx->rxRead = written;
 }
 
 
@@ -106,10 +308,277 @@ HAL_StatusTypeDef SP_HandleUARTError(SP_Context_t *sp_ctx)
 		return HAL_ERROR;
 	}
 
-	if (HAL_UART_GetError(sp_ctx->phuart) != HAL_UART_ERROR_NONE)
+	// DMA Tx error - chunk is lost, continue with the rest of the ring
+	if ((sp_ctx->txDmaLen != 0) && (sp_ctx->phuart->gState == HAL_UART_STATE_READY))
+	{
+		SP_TxCompleteFromISR(sp_ctx);
+	}
+
+	// In DMA mode every UART error aborts reception (RxState back to READY)
+	if (sp_ctx->phuart->RxState == HAL_UART_STATE_READY)
 	{
-		return SP_StartRecToIdle_DMA(sp_ctx->phuart, sp_ctx->rxStorage.raw_data, sp_ctx->rxStorage.size);
+		return SP_RxStart(sp_ctx);
 	}
 
 	return HAL_ERROR;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Reconfigure UART baud rate and restart circular Rx - task context.
+ *        Tx ring must be empty (caller drains it first).
+ * 
+ * @param sp_ctx 
+ * @param baud 
+ * @return HAL_StatusTypeDef 
+ */
+HAL_StatusTypeDef SP_ChangeBaudRate(SP_Context_t *sp_ctx, uint32_t baud)
+{
+	UART_HandleTypeDef *huart = sp_ctx->phuart;
+
+	if (SP_TxIdle(sp_ctx) == false)
+	{
+		return HAL_BUSY;
+	}
+
+	HAL_UART_AbortReceive(huart);
+
+	// MspInit se znovu nevola (gState neni RESET) - meni se jen BRR
+	huart->Init.BaudRate = baud;
+	if (HAL_UART_Init(huart) != HAL_OK)
+	{
+		return HAL_ERROR;
+	}
+
+	SP_RxResync(sp_ctx);
+	return SP_RxStart(sp_ctx);
+}
+
+
+/**
+ * @brief Start DMA for the next contiguous part of Tx ring - must be called
+ *        with interrupts disabled
+ * 
+ * @param sp_ctx 
+ */
+static void SP_TxKick(SP_Context_t *sp_ctx)
+{
+	uint16_t head = sp_ctx->txHead;
+	uint16_t tail = sp_ctx->txTail;
+	uint16_t len;
+
+	if (sp_ctx->txDmaLen != 0)
+	{
+		return;
+	}
+
+	// Vse zapsane pred const bufferem uz odeslo - ted on
+	if ((sp_ctx->txExtLen != 0) && (tail == sp_ctx->txExtAt))
+	{
+		sp_ctx->txExtActive = true;
+		sp_ctx->txDmaLen = sp_ctx->txExtLen;
+		if (HAL_UART_Transmit_DMA(sp_ctx->phuart, (uint8_t *)sp_ctx->txExtData, sp_ctx->txExtLen) != HAL_OK)
+		{
+			sp_ctx->txExtActive = false;
+			sp_ctx->txExtLen = 0;
+			sp_ctx->txDmaLen = 0;
+		}
+		else
+		{
+			return;
+		}
+	}
+
+	if (head == tail)
+	{
+		return;
+	}
+
+	// Do konce ringu, zbytek se posle po dokonceni tohoto bloku
+	len = (head > tail) ? (uint16_t)(head - tail) : (uint16_t)(sp_ctx->txStorage.size - tail);
+
+	// Nejdal po misto, kde ceka const buffer
+	if ((sp_ctx->txExtLen != 0) && (sp_ctx->txExtAt > tail) && ((uint16_t)(sp_ctx->txExtAt - tail) < len))
+	{
+		len = (uint16_t)(sp_ctx->txExtAt - tail);
+	}
+
+	sp_ctx->txDmaLen = len;
+	if (HAL_UART_Transmit_DMA(sp_ctx->phuart, &sp_ctx->txStorage.raw_data[tail], len) != HAL_OK)
+	{
+		sp_ctx->txDmaLen = 0;
+	}
+}
+
+
+/**
+ * @brief Copy data into Tx ring and start DMA if idle. Does not block.
+ * 
+ * @param sp_ctx 
+ * @param data 
+ * @param len 
+ * @return uint16_t number of bytes accepted (less than len if ring is full)
+ */
+uint16_t SP_TxWrite(SP_Context_t *sp_ctx, const uint8_t *data, uint16_t len)
+{
+	uint16_t ringSize = sp_ctx->txStorage.size;
+	uint16_t head = sp_ctx->txHead;
+	uint16_t tail = sp_ctx->txTail;
+	uint16_t used = (uint16_t)((head + ringSize - tail) % ringSize);
+	uint16_t space = (uint16_t)(ringSize - 1 - used);
+	uint16_t chunk;
+	uint32_t primask;
+
+	if (len > space)
+	{
+		len = space;
+	}
+
+	// Max. dva bloky - do konce ringu a od zacatku
+	chunk = (uint16_t)(ringSize - head);
+	if (chunk > len)
+	{
+		chunk = len;
+	}
+	memcpy(&sp_ctx->txStorage.raw_data[head], data, chunk);
+	memcpy(sp_ctx->txStorage.raw_data, &data[chunk], len - chunk);
+
+	used += len;
+	if (used > sp_ctx->txHighWater)
+	{
+		sp_ctx->txHighWater = used;
+	}
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	sp_ctx->txHead = (uint16_t)((head + len) % ringSize);
+	SP_TxKick(sp_ctx);
+	__set_PRIMASK(primask);
+
+	return len;
+}
+
+
+/**
+ * @brief Get free Tx ring space so the caller can format data straight into
+ *        the ring. Nothing is sent until SP_TxCommit. Single writer only.
+ * 
+ * @param sp_ctx 
+ * @param span filled with max. two contiguous parts
+ * @return uint16_t total free bytes
+ */
+uint16_t SP_TxReserve(SP_Context_t *sp_ctx, SP_TxSpan_t *span)
+{
+	uint16_t ringSize = sp_ctx->txStorage.size;
+	uint16_t head = sp_ctx->txHead;
+	uint16_t tail = sp_ctx->txTail;
+	uint16_t used = (uint16_t)((head + ringSize - tail) % ringSize);
+	uint16_t space = (uint16_t)(ringSize - 1 - used);
+
+	span->part[0] = &sp_ctx->txStorage.raw_data[head];
+	span->partLen[0] = (uint16_t)(ringSize - head);
+	if (span->partLen[0] > space)
+	{
+		span->partLen[0] = space;
+	}
+	span->part[1] = sp_ctx->txStorage.raw_data;
+	span->partLen[1] = (uint16_t)(space - span->partLen[0]);
+
+	return space;
+}
+
+/**
+ * @brief Publish len bytes written into the span from SP_TxReserve and start
+ *        DMA if idle
+ * 
+ * @param sp_ctx 
+ * @param len 
+ */
+void SP_TxCommit(SP_Context_t *sp_ctx, uint16_t len)
+{
+	uint16_t ringSize = sp_ctx->txStorage.size;
+	uint16_t head = sp_ctx->txHead;
+	uint16_t used = (uint16_t)((head + ringSize - sp_ctx->txTail) % ringSize) + len;
+	uint32_t primask;
+
+	if (used > sp_ctx->txHighWater)
+	{
+		sp_ctx->txHighWater = used;
+	}
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	sp_ctx->txHead = (uint16_t)((head + len) % ringSize);
+	SP_TxKick(sp_ctx);
+	__set_PRIMASK(primask);
+}
+
+
+/**
+ * @brief Queue a const (flash) buffer for DMA without copying it into the ring.
+ *        It is sent after everything already in the ring, data written later
+ *        follow it. Only one such buffer can be pending. Does not block.
+ * 
+ * @param sp_ctx 
+ * @param data must stay valid until sent
+ * @param len 
+ * @return true 
+ * @return false if another const buffer is still pending
+ */
+bool SP_TxWriteConst(SP_Context_t *sp_ctx, const uint8_t *data, uint16_t len)
+{
+	uint32_t primask;
+	bool ret = false;
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	if (sp_ctx->txExtLen == 0)
+	{
+		sp_ctx->txExtData = data;
+		sp_ctx->txExtAt = sp_ctx->txHead;
+		sp_ctx->txExtLen = len;
+		SP_TxKick(sp_ctx);
+		ret = true;
+	}
+	__set_PRIMASK(primask);
+
+	return ret;
+}
+
+
+/**
+ * @brief DMA Tx chunk finished - release it and continue with the rest (ISR)
+ * 
+ * @param sp_ctx 
+ */
+void SP_TxCompleteFromISR(SP_Context_t *sp_ctx)
+{
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+	if (sp_ctx->txExtActive)
+	{
+		// Const buffer odeslan, ring se nemeni
+		sp_ctx->txExtActive = false;
+		sp_ctx->txExtLen = 0;
+	}
+	else
+	{
+		sp_ctx->txTail = (uint16_t)((sp_ctx->txTail + sp_ctx->txDmaLen) % sp_ctx->txStorage.size);
+	}
+	sp_ctx->txDmaLen = 0;
+	SP_TxKick(sp_ctx);
+
+	__set_PRIMASK(primask);
+}
+
+
+/**
+ * @brief 
+ * 
+ * @param sp_ctx 
+ * @return true if Tx ring is empty and nothing is being sent
+ */
+bool SP_TxIdle(SP_Context_t *sp_ctx)
+{
+	return (sp_ctx->txDmaLen == 0) && (sp_ctx->txHead == sp_ctx->txTail) && (sp_ctx->txExtLen == 0);
+}
@@ -15,7 +15,18 @@
 #include "main.h"
 
 #define MAX_UART_RX_BUFFER 550
-#define MAX_UART_TX_BUFFER 550
+#define MAX_UART_TX_BUFFER 1024     // Tx ring drained by DMA
+
+/* Circular DMA RX ring - HT/TC/IDLE events drain it. Must hold the longest legal
+   line (AT+RF_TX_HEX) while the command FIFO is full, plus the task latency
+   (768 B = ~67 ms @ 115200 Bd) */
+#ifndef SP_RX_RING_SIZE
+#define SP_RX_RING_SIZE    768
+#endif
+
+#if (SP_RX_RING_SIZE <= MAX_UART_RX_BUFFER)
+#error "SP_RX_RING_SIZE must be larger than the longest AT line (MAX_UART_RX_BUFFER)"
+#endif
 
 typedef struct 
 {
@@ -30,13 +41,47 @@ typedef struct
 	UART_HandleTypeDef *phuart;			//!< Pointer to UART handle.
 	RAW_DATA_Storage_t rxStorage;				//!< Rx storage instance.
 	RAW_DATA_Storage_t txStorage;				//!< Tx storage instance.
+	uint16_t rxTail;							//!< Read index into circular Rx ring (task side).
+	uint32_t rxRead;							//!< Bytes consumed from Rx ring since DMA start (task side).
+	uint16_t rxIsrHead;							//!< Last DMA write position seen in ISR.
+	volatile uint32_t rxWritten;				//!< Bytes written by DMA since start (ISR side) - detects ring lap.
+	volatile uint16_t txHead;					//!< Write index into Tx ring (writer side).
+	volatile uint16_t txTail;					//!< Start of data not yet sent (DMA side).
+	volatile uint16_t txDmaLen;					//!< Length of chunk in flight, 0 = DMA idle.
+	uint16_t txHighWater;						//!< Max. Tx ring fill level.
+	const uint8_t *txExtData;					//!< Const buffer sent by DMA in place (no copy into ring).
+	volatile uint16_t txExtLen;					//!< Its length, 0 = none pending.
+	uint16_t txExtAt;							//!< Ring position the buffer is sent at (keeps ordering).
+	volatile bool txExtActive;					//!< DMA is sending the const buffer.
 
 }__attribute__((packed)) SP_Context_t;	//Serial Port ctx
 
 
+/* Free Tx ring space for in-place formatting - from head to ring end and from ring start */
+typedef struct
+{
+	uint8_t *part[2];
+	uint16_t partLen[2];
+
+} SP_TxSpan_t;
+
+
 bool SP_PlatformInit(SP_Context_t *sp_ctx);
 HAL_StatusTypeDef SP_HandleUARTError(SP_Context_t *sp_ctx);
-bool SP_RxComplete(SP_Context_t *sp_ctx, uint16_t size);
+HAL_StatusTypeDef SP_ChangeBaudRate(SP_Context_t *sp_ctx, uint32_t baud);
+uint16_t SP_RxRead(SP_Context_t *sp_ctx, uint16_t head, uint8_t *dst, uint16_t maxLen);
+uint16_t SP_RxReadLine(SP_Context_t *sp_ctx, uint16_t head, uint8_t *dst, uint16_t maxLen, bool *eol);
+uint16_t SP_RxReadFrame(SP_Context_t *sp_ctx, uint16_t head, uint8_t *dst, uint16_t maxLen, bool *eof);
+void SP_RxResync(SP_Context_t *sp_ctx);
+uint32_t SP_RxEventFromISR(SP_Context_t *sp_ctx, uint16_t head);
+bool SP_RxOverrun(SP_Context_t *sp_ctx, uint32_t written);
+void SP_RxSkip(SP_Context_t *sp_ctx, uint16_t head, uint32_t written);
+uint16_t SP_TxWrite(SP_Context_t *sp_ctx, const uint8_t *data, uint16_t len);
+bool SP_TxWriteConst(SP_Context_t *sp_ctx, const uint8_t *data, uint16_t len);
+uint16_t SP_TxReserve(SP_Context_t *sp_ctx, SP_TxSpan_t *span);
+void SP_TxCommit(SP_Context_t *sp_ctx, uint16_t len);
+void SP_TxCompleteFromISR(SP_Context_t *sp_ctx);
+bool SP_TxIdle(SP_Context_t *sp_ctx);
 
 
 #endif // PORTSTM32L071XX_H
\ No newline at end of file
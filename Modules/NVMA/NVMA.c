@@ -13,6 +13,7 @@
 #include "main.h"
 #include "NVMA.h"
 #include "semphr.h"
+#include <string.h>
 
 
 static SemaphoreHandle_t xEepromMutex;
@@ -79,6 +80,7 @@ bool NVMA_InitDefaults(void)
 {
     uint32_t magic = 0;
     bool success = true;
+    const uint8_t gfskSync[] = NVMA_DEFAULT_GFSK_SYNC;
     
     // Read magic value to check if EEPROM was ever initialized
     xSemaphoreTake(xEepromMutex, portMAX_DELAY);
@@ -115,6 +117,19 @@ bool NVMA_InitDefaults(void)
         NVMA_Set_LR_Pckt_Size(0);  // No saved packet TODO
         NVMA_Set_LR_SyncWord_TX(NVMA_DEFAULT_SYNC_WORD);
         NVMA_Set_LR_SyncWord_RX(NVMA_DEFAULT_SYNC_WORD);
+        NVMA_Set_LR_CAD_Params(NVMA_DEFAULT_CAD_SYMB, NVMA_DEFAULT_CAD_DET_PEAK, NVMA_DEFAULT_CAD_DET_MIN);
+        NVMA_Set_LR_LBT_Params(NVMA_DEFAULT_LBT_ATTEMPTS, NVMA_DEFAULT_LBT_BACKOFF_MS);
+        NVMA_Set_LR_RX_Sniff(NVMA_DEFAULT_RX_SNIFF);
+        NVMA_Set_LR_FHSS_Params(NVMA_DEFAULT_LR_FHSS_CR, NVMA_DEFAULT_LR_FHSS_BW, NVMA_DEFAULT_LR_FHSS_GRID, NVMA_DEFAULT_LR_FHSS_HOP_SEQ);
+        NVMA_Set_LR_FHSS_Sync(NVMA_DEFAULT_LR_FHSS_SYNC);
+        NVMA_Set_RF_Modem(NVMA_DEFAULT_RF_MODEM);
+        NVMA_Set_GFSK_Bitrate(NVMA_DEFAULT_GFSK_BITRATE);
+        NVMA_Set_GFSK_Fdev(NVMA_DEFAULT_GFSK_FDEV);
+        NVMA_Set_GFSK_BW(NVMA_DEFAULT_GFSK_BW);
+        NVMA_Set_GFSK_Preamble(NVMA_DEFAULT_GFSK_PREAMBLE);
+        NVMA_Set_GFSK_CRC(NVMA_DEFAULT_GFSK_CRC);
+        NVMA_Set_GFSK_Whitening(NVMA_DEFAULT_GFSK_WHITENING);
+        NVMA_Set_GFSK_SyncWord(gfskSync, NVMA_DEFAULT_GFSK_SYNC_LEN);
         
         // Write magic value to indicate initialization complete
         xSemaphoreTake(xEepromMutex, portMAX_DELAY);
@@ -872,7 +887,8 @@ void NVMA_Get_LR_RX_PldLen(uint8_t *len)
  */
 bool NVMA_Is_Valid_Baud(uint32_t baud)
 {
-    const uint32_t valid_bauds[] = {9600, 19200, 38400, 57600, 115200, 230400};
+    // 2 Mbaud = PCLK2 (32 MHz) / 16 - max. pro oversampling 16
+    const uint32_t valid_bauds[] = {9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600, 1000000, 2000000};
     for (size_t i = 0; i < sizeof(valid_bauds) / sizeof(valid_bauds[0]); i++)
     {
         if (baud == valid_bauds[i])
@@ -885,7 +901,7 @@ bool NVMA_Is_Valid_Baud(uint32_t baud)
 
 /**
  * @brief Set UART baud rate
- * @param baud Baud rate (9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600)
+ * @param baud Baud rate (9600 ... 2000000, see NVMA_Is_Valid_Baud)
  */
 void NVMA_Set_UART_Baud(uint32_t baud)
 {   
@@ -980,4 +996,459 @@ void NVMA_Get_LR_SyncWord_RX(uint8_t *sync_word)
     xSemaphoreTake(xEepromMutex, portMAX_DELAY);
     *sync_word = *((uint8_t *)EE_ADDR_LR_SYNC_WORD_RX);
     xSemaphoreGive(xEepromMutex);
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Check CAD length in symbols (SX126x supports 1, 2, 4, 8, 16)
+ * @param symb
+ * @return true if valid
+ */
+bool NVMA_Is_Valid_CAD_Symb(uint8_t symb)
+{
+    return (symb == 1) || (symb == 2) || (symb == 4) || (symb == 8) || (symb == 16);
+}
+
+/**
+ * @brief Set CAD parameters used by listen-before-talk
+ * @param symb CAD length in symbols
+ * @param detPeak cad_det_peak
+ * @param detMin cad_det_min
+ */
+void NVMA_Set_LR_CAD_Params(uint8_t symb, uint8_t detPeak, uint8_t detMin)
+{
+    uint32_t word = (uint32_t)symb | ((uint32_t)detPeak << 8) | ((uint32_t)detMin << 16);
+
+    xSemaphoreTake(xEepromMutex, portMAX_DELAY);
+    NVMA_ClearFlashErrors();
+    HAL_FLASHEx_DATAEEPROM_Unlock();
+    HAL_FLASHEx_DATAEEPROM_Program(FLASH_TYPEPROGRAMDATA_WORD, EE_ADDR_LR_CAD_PARAMS, word);
+    HAL_FLASHEx_DATAEEPROM_Lock();
+    xSemaphoreGive(xEepromMutex);
+}
+
+/**
+ * @brief Get CAD parameters
+ * @note Returns defaults if stored value is invalid
+ */
+void NVMA_Get_LR_CAD_Params(uint8_t *symb, uint8_t *detPeak, uint8_t *detMin)
+{
+    uint32_t word;
+
+    xSemaphoreTake(xEepromMutex, portMAX_DELAY);
+    word = *((uint32_t *)EE_ADDR_LR_CAD_PARAMS);
+    xSemaphoreGive(xEepromMutex);
+
+    *symb = (uint8_t)(word & 0xFF);
+    *detPeak = (uint8_t)((word >> 8) & 0xFF);
+    *detMin = (uint8_t)((word >> 16) & 0xFF);
+
+    if (!NVMA_Is_Valid_CAD_Symb(*symb) || ((word >> 24) != 0))
+    {
+        *symb = NVMA_DEFAULT_CAD_SYMB;
+        *detPeak = NVMA_DEFAULT_CAD_DET_PEAK;
+        *detMin = NVMA_DEFAULT_CAD_DET_MIN;
+    }
+}
+
+/**
+ * @brief Set listen-before-talk retry parameters
+ * @param maxAttempts CAD attempts before packet is dropped (1-16)
+ * @param backoffMs base of randomized exponential backoff
+ */
+void NVMA_Set_LR_LBT_Params(uint8_t maxAttempts, uint16_t backoffMs)
+{
+    uint32_t word = (uint32_t)maxAttempts | ((uint32_t)backoffMs << 16);
+
+    xSemaphoreTake(xEepromMutex, portMAX_DELAY);
+    NVMA_ClearFlashErrors();
+    HAL_FLASHEx_DATAEEPROM_Unlock();
+    HAL_FLASHEx_DATAEEPROM_Program(FLASH_TYPEPROGRAMDATA_WORD, EE_ADDR_LR_LBT_PARAMS, word);
+    HAL_FLASHEx_DATAEEPROM_Lock();
+    xSemaphoreGive(xEepromMutex);
+}
+
+/**
+ * @brief Get listen-before-talk retry parameters
+ * @note Returns defaults if stored value is invalid
+ */
+void NVMA_Get_LR_LBT_Params(uint8_t *maxAttempts, uint16_t *backoffMs)
+{
+    uint32_t word;
+
+    xSemaphoreTake(xEepromMutex, portMAX_DELAY);
+    word = *((uint32_t *)EE_ADDR_LR_LBT_PARAMS);
+    xSemaphoreGive(xEepromMutex);
+
+    *maxAttempts = (uint8_t)(word & 0xFF);
+    *backoffMs = (uint16_t)(word >> 16);
+
+    if ((*maxAttempts == 0) || (*maxAttempts > NVMA_LBT_MAX_ATTEMPTS) ||
+        (*backoffMs == 0) || (*backoffMs > NVMA_LBT_MAX_BACKOFF_MS) || (((word >> 8) & 0xFF) != 0))
+    {
+        *maxAttempts = NVMA_DEFAULT_LBT_ATTEMPTS;
+        *backoffMs = NVMA_DEFAULT_LBT_BACKOFF_MS;
+    }
+}
+
+/**
+ * @brief Set RX sniff (duty-cycle) mode
+ * @param sniff 0=continuous RX, 1=sniff
+ */
+void NVMA_Set_LR_RX_Sniff(uint8_t sniff)
+{
+    xSemaphoreTake(xEepromMutex, portMAX_DELAY);
+    NVMA_ClearFlashErrors();
+    HAL_FLASHEx_DATAEEPROM_Unlock();
+    HAL_FLASHEx_DATAEEPROM_Program(FLASH_TYPEPROGRAMDATA_BYTE, EE_ADDR_LR_RX_SNIFF, sniff);
+    HAL_FLASHEx_DATAEEPROM_Lock();
+    xSemaphoreGive(xEepromMutex);
+}
+
+/**
+ * @brief Get RX sniff (duty-cycle) mode
+ * @note Returns continuous RX (0) if invalid value stored
+ */
+void NVMA_Get_LR_RX_Sniff(uint8_t *sniff)
+{
+    xSemaphoreTake(xEepromMutex, portMAX_DELAY);
+    *sniff = *((uint8_t *)EE_ADDR_LR_RX_SNIFF);
+    xSemaphoreGive(xEepromMutex);
+
+    if (*sniff > 1)
+    {
+        *sniff = NVMA_DEFAULT_RX_SNIFF;
+    }
+}
+
+/**
+ * @brief Set LR-FHSS TX parameters
+ * @param cr 0=5/6, 1=2/3, 2=1/2, 3=1/3
+ * @param bw 0-9 (39.063 kHz - 1574.219 kHz)
+ * @param grid 0=25.391 kHz, 1=3.906 kHz
+ * @param hopSeq hop sequence ID or NVMA_LR_FHSS_HOP_SEQ_RANDOM
+ */
+void NVMA_Set_LR_FHSS_Params(uint8_t cr, uint8_t bw, uint8_t grid, uint16_t hopSeq)
+{
+    uint32_t word = (uint32_t)(cr & 0x0F) | ((uint32_t)(bw & 0x0F) << 4) | ((uint32_t)grid << 8) | ((uint32_t)hopSeq << 16);
+
+    xSemaphoreTake(xEepromMutex, portMAX_DELAY);
+    NVMA_ClearFlashErrors();
+    HAL_FLASHEx_DATAEEPROM_Unlock();
+    HAL_FLASHEx_DATAEEPROM_Program(FLASH_TYPEPROGRAMDATA_WORD, EE_ADDR_LR_FHSS_PARAMS, word);
+    HAL_FLASHEx_DATAEEPROM_Lock();
+    xSemaphoreGive(xEepromMutex);
+}
+
+/**
+ * @brief Get LR-FHSS TX parameters
+ * @note Returns defaults if stored value is invalid
+ */
+void NVMA_Get_LR_FHSS_Params(uint8_t *cr, uint8_t *bw, uint8_t *grid, uint16_t *hopSeq)
+{
+    uint32_t word;
+
+    xSemaphoreTake(xEepromMutex, portMAX_DELAY);
+    word = *((uint32_t *)EE_ADDR_LR_FHSS_PARAMS);
+    xSemaphoreGive(xEepromMutex);
+
+    *cr = (uint8_t)(word & 0x0F);
+    *bw = (uint8_t)((word >> 4) & 0x0F);
+    *grid = (uint8_t)((word >> 8) & 0xFF);
+    *hopSeq = (uint16_t)(word >> 16);
+
+    if ((*cr > NVMA_LR_FHSS_MAX_CR) || (*bw > NVMA_LR_FHSS_MAX_BW) || (*grid > NVMA_LR_FHSS_MAX_GRID) ||
+        ((*hopSeq > NVMA_LR_FHSS_MAX_HOP_SEQ) && (*hopSeq != NVMA_LR_FHSS_HOP_SEQ_RANDOM)))
+    {
+        *cr = NVMA_DEFAULT_LR_FHSS_CR;
+        *bw = NVMA_DEFAULT_LR_FHSS_BW;
+        *grid = NVMA_DEFAULT_LR_FHSS_GRID;
+        *hopSeq = NVMA_DEFAULT_LR_FHSS_HOP_SEQ;
+    }
+}
+
+/**
+ * @brief Set LR-FHSS sync word
+ * @param sync 4 bytes, MSB is sent first
+ */
+void NVMA_Set_LR_FHSS_Sync(uint32_t sync)
+{
+    xSemaphoreTake(xEepromMutex, portMAX_DELAY);
+    NVMA_ClearFlashErrors();
+    HAL_FLASHEx_DATAEEPROM_Unlock();
+    HAL_FLASHEx_DATAEEPROM_Program(FLASH_TYPEPROGRAMDATA_WORD, EE_ADDR_LR_FHSS_SYNC, sync);
+    HAL_FLASHEx_DATAEEPROM_Lock();
+    xSemaphoreGive(xEepromMutex);
+}
+
+/**
+ * @brief Get LR-FHSS sync word
+ */
+void NVMA_Get_LR_FHSS_Sync(uint32_t *sync)
+{
+    xSemaphoreTake(xEepromMutex, portMAX_DELAY);
+    *sync = *((uint32_t *)EE_ADDR_LR_FHSS_SYNC);
+    xSemaphoreGive(xEepromMutex);
+}
+
+/**
+ * @brief Set modem used for RF TX / RX
+ * 
+ * @param modem 
+ */
+void NVMA_Set_RF_Modem(uint8_t modem)
+{
+    xSemaphoreTake(xEepromMutex, portMAX_DELAY);
+    NVMA_ClearFlashErrors();
+    HAL_FLASHEx_DATAEEPROM_Unlock();
+    HAL_FLASHEx_DATAEEPROM_Program(FLASH_TYPEPROGRAMDATA_BYTE, EE_ADDR_RF_MODEM, modem);
+    HAL_FLASHEx_DATAEEPROM_Lock();
+    xSemaphoreGive(xEepromMutex);
+}
+
+/**
+ * @brief Get modem used for RF TX / RX
+ * @note Returns default if stored value is invalid
+ */
+void NVMA_Get_RF_Modem(uint8_t *modem)
+{
+    xSemaphoreTake(xEepromMutex, portMAX_DELAY);
+    *modem = *((uint8_t *)EE_ADDR_RF_MODEM);
+    xSemaphoreGive(xEepromMutex);
+
+    if (*modem > RF_MODEM_GFSK)
+    {
+        *modem = NVMA_DEFAULT_RF_MODEM;
+    }
+}
+
+/**
+ * @brief Set GFSK bitrate [bps]
+ * 
+ * @param bitrate 
+ */
+void NVMA_Set_GFSK_Bitrate(uint32_t bitrate)
+{
+    xSemaphoreTake(xEepromMutex, portMAX_DELAY);
+    NVMA_ClearFlashErrors();
+    HAL_FLASHEx_DATAEEPROM_Unlock();
+    HAL_FLASHEx_DATAEEPROM_Program(FLASH_TYPEPROGRAMDATA_WORD, EE_ADDR_GFSK_BITRATE, bitrate);
+    HAL_FLASHEx_DATAEEPROM_Lock();
+    xSemaphoreGive(xEepromMutex);
+}
+
+/**
+ * @brief Get GFSK bitrate [bps]
+ * @note Returns default if stored value is invalid
+ */
+void NVMA_Get_GFSK_Bitrate(uint32_t *bitrate)
+{
+    xSemaphoreTake(xEepromMutex, portMAX_DELAY);
+    *bitrate = *((uint32_t *)EE_ADDR_GFSK_BITRATE);
+    xSemaphoreGive(xEepromMutex);
+
+    if ((*bitrate < NVMA_GFSK_MIN_BITRATE) || (*bitrate > NVMA_GFSK_MAX_BITRATE))
+    {
+        *bitrate = NVMA_DEFAULT_GFSK_BITRATE;
+    }
+}
+
+/**
+ * @brief Set GFSK frequency deviation [Hz]
+ * 
+ * @param fdev 
+ */
+void NVMA_Set_GFSK_Fdev(uint32_t fdev)
+{
+    xSemaphoreTake(xEepromMutex, portMAX_DELAY);
+    NVMA_ClearFlashErrors();
+    HAL_FLASHEx_DATAEEPROM_Unlock();
+    HAL_FLASHEx_DATAEEPROM_Program(FLASH_TYPEPROGRAMDATA_WORD, EE_ADDR_GFSK_FDEV, fdev);
+    HAL_FLASHEx_DATAEEPROM_Lock();
+    xSemaphoreGive(xEepromMutex);
+}
+
+/**
+ * @brief Get GFSK frequency deviation [Hz]
+ * @note Returns default if stored value is invalid
+ */
+void NVMA_Get_GFSK_Fdev(uint32_t *fdev)
+{
+    xSemaphoreTake(xEepromMutex, portMAX_DELAY);
+    *fdev = *((uint32_t *)EE_ADDR_GFSK_FDEV);
+    xSemaphoreGive(xEepromMutex);
+
+    if ((*fdev < NVMA_GFSK_MIN_FDEV) || (*fdev > NVMA_GFSK_MAX_FDEV))
+    {
+        *fdev = NVMA_DEFAULT_GFSK_FDEV;
+    }
+}
+
+/**
+ * @brief Set GFSK RX bandwidth (double sideband) [Hz]
+ * 
+ * @param bw 
+ */
+void NVMA_Set_GFSK_BW(uint32_t bw)
+{
+    xSemaphoreTake(xEepromMutex, portMAX_DELAY);
+    NVMA_ClearFlashErrors();
+    HAL_FLASHEx_DATAEEPROM_Unlock();
+    HAL_FLASHEx_DATAEEPROM_Program(FLASH_TYPEPROGRAMDATA_WORD, EE_ADDR_GFSK_BW, bw);
+    HAL_FLASHEx_DATAEEPROM_Lock();
+    xSemaphoreGive(xEepromMutex);
+}
+
+/**
+ * @brief Get GFSK RX bandwidth (double sideband) [Hz]
+ * @note Returns default if stored value is invalid
+ */
+void NVMA_Get_GFSK_BW(uint32_t *bw)
+{
+    xSemaphoreTake(xEepromMutex, portMAX_DELAY);
+    *bw = *((uint32_t *)EE_ADDR_GFSK_BW);
+    xSemaphoreGive(xEepromMutex);
+
+    if ((*bw < NVMA_GFSK_MIN_BW) || (*bw > NVMA_GFSK_MAX_BW))
+    {
+        *bw = NVMA_DEFAULT_GFSK_BW;
+    }
+}
+
+/**
+ * @brief Set GFSK preamble length [bits]
+ * 
+ * @param bits 
+ */
+void NVMA_Set_GFSK_Preamble(uint16_t bits)
+{
+    xSemaphoreTake(xEepromMutex, portMAX_DELAY);
+    NVMA_ClearFlashErrors();
+    HAL_FLASHEx_DATAEEPROM_Unlock();
+    HAL_FLASHEx_DATAEEPROM_Program(FLASH_TYPEPROGRAMDATA_HALFWORD, EE_ADDR_GFSK_PREAMBLE, bits);
+    HAL_FLASHEx_DATAEEPROM_Lock();
+    xSemaphoreGive(xEepromMutex);
+}
+
+/**
+ * @brief Get GFSK preamble length [bits]
+ * @note Returns default if stored value is invalid
+ */
+void NVMA_Get_GFSK_Preamble(uint16_t *bits)
+{
+    xSemaphoreTake(xEepromMutex, portMAX_DELAY);
+    *bits = *((uint16_t *)EE_ADDR_GFSK_PREAMBLE);
+    xSemaphoreGive(xEepromMutex);
+
+    if (*bits < NVMA_GFSK_MIN_PREAMBLE)
+    {
+        *bits = NVMA_DEFAULT_GFSK_PREAMBLE;
+    }
+}
+
+/**
+ * @brief Set GFSK CRC type (ral_gfsk_crc_type_t)
+ * 
+ * @param crc 
+ */
+void NVMA_Set_GFSK_CRC(uint8_t crc)
+{
+    xSemaphoreTake(xEepromMutex, portMAX_DELAY);
+    NVMA_ClearFlashErrors();
+    HAL_FLASHEx_DATAEEPROM_Unlock();
+    HAL_FLASHEx_DATAEEPROM_Program(FLASH_TYPEPROGRAMDATA_BYTE, EE_ADDR_GFSK_CRC, crc);
+    HAL_FLASHEx_DATAEEPROM_Lock();
+    xSemaphoreGive(xEepromMutex);
+}
+
+/**
+ * @brief Get GFSK CRC type (ral_gfsk_crc_type_t)
+ * @note Returns default if stored value is invalid
+ */
+void NVMA_Get_GFSK_CRC(uint8_t *crc)
+{
+    xSemaphoreTake(xEepromMutex, portMAX_DELAY);
+    *crc = *((uint8_t *)EE_ADDR_GFSK_CRC);
+    xSemaphoreGive(xEepromMutex);
+
+    if (*crc > NVMA_GFSK_MAX_CRC)
+    {
+        *crc = NVMA_DEFAULT_GFSK_CRC;
+    }
+}
+
+/**
+ * @brief Set GFSK data whitening
+ * 
+ * @param whitening 
+ */
+void NVMA_Set_GFSK_Whitening(uint8_t whitening)
+{
+    xSemaphoreTake(xEepromMutex, portMAX_DELAY);
+    NVMA_ClearFlashErrors();
+    HAL_FLASHEx_DATAEEPROM_Unlock();
+    HAL_FLASHEx_DATAEEPROM_Program(FLASH_TYPEPROGRAMDATA_BYTE, EE_ADDR_GFSK_WHITENING, whitening);
+    HAL_FLASHEx_DATAEEPROM_Lock();
+    xSemaphoreGive(xEepromMutex);
+}
+
+/**
+ * @brief Get GFSK data whitening
+ * @note Returns default if stored value is invalid
+ */
+void NVMA_Get_GFSK_Whitening(uint8_t *whitening)
+{
+    xSemaphoreTake(xEepromMutex, portMAX_DELAY);
+    *whitening = *((uint8_t *)EE_ADDR_GFSK_WHITENING);
+    xSemaphoreGive(xEepromMutex);
+
+    if (*whitening > 1)
+    {
+        *whitening = NVMA_DEFAULT_GFSK_WHITENING;
+    }
+}
+
+/**
+ * @brief Set GFSK sync word
+ * 
+ * @param sync 
+ * @param len 1-8 B
+ */
+void NVMA_Set_GFSK_SyncWord(const uint8_t *sync, uint8_t len)
+{
+    xSemaphoreTake(xEepromMutex, portMAX_DELAY);
+    NVMA_ClearFlashErrors();
+    HAL_FLASHEx_DATAEEPROM_Unlock();
+    HAL_FLASHEx_DATAEEPROM_Program(FLASH_TYPEPROGRAMDATA_BYTE, EE_ADDR_GFSK_SYNC_LEN, len);
+    for (uint8_t i = 0; i < len; i++)
+    {
+        HAL_FLASHEx_DATAEEPROM_Program(FLASH_TYPEPROGRAMDATA_BYTE, EE_ADDR_GFSK_SYNC + i, sync[i]);
+    }
+    HAL_FLASHEx_DATAEEPROM_Lock();
+    xSemaphoreGive(xEepromMutex);
+}
+
+/**
+ * @brief Get GFSK sync word
+ * @note Returns default if stored length is invalid
+ * 
+ * @param sync buffer of NVMA_GFSK_MAX_SYNC_LEN bytes
+ * @param len 
+ */
+void NVMA_Get_GFSK_SyncWord(uint8_t *sync, uint8_t *len)
+{
+    static const uint8_t defSync[] = NVMA_DEFAULT_GFSK_SYNC;
+
+    xSemaphoreTake(xEepromMutex, portMAX_DELAY);
+    *len = *((uint8_t *)EE_ADDR_GFSK_SYNC_LEN);
+    if ((*len > 0) && (*len <= NVMA_GFSK_MAX_SYNC_LEN))
+    {
+        memcpy(sync, (uint8_t *)EE_ADDR_GFSK_SYNC, *len);
+    }
+    xSemaphoreGive(xEepromMutex);
+
+    if ((*len == 0) || (*len > NVMA_GFSK_MAX_SYNC_LEN))
+    {
+        *len = NVMA_DEFAULT_GFSK_SYNC_LEN;
+        memcpy(sync, defSync, *len);
+    }
+}
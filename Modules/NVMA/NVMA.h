@@ -40,15 +40,33 @@
 #define EE_ADDR_LR_RX_PLDLEN                    (EE_ADDR_LR_RX_LDRO + sizeof(uint32_t))
 #define EE_ADDR_UART_BAUD                       (EE_ADDR_LR_RX_PLDLEN + sizeof(uint32_t))
 #define EE_ADDR_RX_FORMAT                       (EE_ADDR_UART_BAUD + sizeof(uint32_t))
-#define EE_ADDR_INIT_MAGIC                      (EE_ADDR_RX_FORMAT + sizeof(uint32_t))
+#define EE_ADDR_LR_CAD_PARAMS                   (EE_ADDR_RX_FORMAT + sizeof(uint32_t))      // symb | peak << 8 | min << 16
+#define EE_ADDR_LR_LBT_PARAMS                   (EE_ADDR_LR_CAD_PARAMS + sizeof(uint32_t))  // attempts | backoff_ms << 16
+#define EE_ADDR_LR_RX_SNIFF                     (EE_ADDR_LR_LBT_PARAMS + sizeof(uint32_t))  //uint8_t
+#define EE_ADDR_LR_FHSS_PARAMS                  (EE_ADDR_LR_RX_SNIFF + sizeof(uint32_t))    // cr | bw << 4 | grid << 8 | hop_seq << 16
+#define EE_ADDR_LR_FHSS_SYNC                    (EE_ADDR_LR_FHSS_PARAMS + sizeof(uint32_t)) // uint32_t, MSB first on air
+#define EE_ADDR_RF_MODEM                        (EE_ADDR_LR_FHSS_SYNC + sizeof(uint32_t))   //uint8_t
+#define EE_ADDR_GFSK_BITRATE                    (EE_ADDR_RF_MODEM + sizeof(uint32_t))
+#define EE_ADDR_GFSK_FDEV                       (EE_ADDR_GFSK_BITRATE + sizeof(uint32_t))
+#define EE_ADDR_GFSK_BW                         (EE_ADDR_GFSK_FDEV + sizeof(uint32_t))
+#define EE_ADDR_GFSK_PREAMBLE                   (EE_ADDR_GFSK_BW + sizeof(uint32_t))        //uint16_t, bits
+#define EE_ADDR_GFSK_CRC                        (EE_ADDR_GFSK_PREAMBLE + sizeof(uint32_t))  //uint8_t
+#define EE_ADDR_GFSK_WHITENING                  (EE_ADDR_GFSK_CRC + sizeof(uint32_t))       //uint8_t
+#define EE_ADDR_GFSK_SYNC_LEN                   (EE_ADDR_GFSK_WHITENING + sizeof(uint32_t)) //uint8_t
+#define EE_ADDR_GFSK_SYNC                       (EE_ADDR_GFSK_SYNC_LEN + sizeof(uint32_t))  // max 8 B
+#define EE_ADDR_INIT_MAGIC                      (EE_ADDR_GFSK_SYNC + (NVMA_GFSK_MAX_SYNC_LEN*sizeof(uint8_t)))
 
 // Magic value to indicate EEPROM has been initialized with defaults
 // Change this value when adding new EEPROM fields to force re-initialization
-#define NVMA_INIT_MAGIC_VALUE                   0xA5A5BE3C
+#define NVMA_INIT_MAGIC_VALUE                   0xA5A5BE40
 
 // Default UART baud rate
 #define NVMA_DEFAULT_UART_BAUD                  230400
 
+// Modem used for RF TX / RX
+#define RF_MODEM_LORA                           0
+#define RF_MODEM_GFSK                           1
+
 // RX output format options
 #define RX_FORMAT_HEX                           0
 #define RX_FORMAT_ASCII                         1
@@ -72,6 +90,48 @@
 #define NVMA_DEFAULT_TX_PERIOD                  1000    // 1 second
 #define NVMA_DEFAULT_RX_PLDLEN                  0       // Auto
 #define NVMA_DEFAULT_SYNC_WORD                  0x12
+#define NVMA_DEFAULT_CAD_SYMB                   4       // CAD over 4 symbols
+#define NVMA_DEFAULT_CAD_DET_PEAK               23
+#define NVMA_DEFAULT_CAD_DET_MIN                10
+#define NVMA_DEFAULT_LBT_ATTEMPTS               5       // CAD attempts before packet is dropped
+#define NVMA_DEFAULT_LBT_BACKOFF_MS             50      // base of exponential backoff
+
+#define NVMA_DEFAULT_RX_SNIFF                   0       // Continuous RX
+
+#define NVMA_DEFAULT_LR_FHSS_CR                 3       // CR 1/3
+#define NVMA_DEFAULT_LR_FHSS_BW                 2       // 136.719 kHz
+#define NVMA_DEFAULT_LR_FHSS_GRID               1       // 3.9 kHz
+#define NVMA_DEFAULT_LR_FHSS_HOP_SEQ            NVMA_LR_FHSS_HOP_SEQ_RANDOM
+#define NVMA_DEFAULT_LR_FHSS_SYNC               0x2C0F7995  // LoRaWAN LR-FHSS sync word
+
+#define NVMA_DEFAULT_RF_MODEM                   RF_MODEM_LORA
+#define NVMA_DEFAULT_GFSK_BITRATE               100000  // 100 kbps
+#define NVMA_DEFAULT_GFSK_FDEV                  50000   // 50 kHz
+#define NVMA_DEFAULT_GFSK_BW                    234300  // 2 * fdev + bitrate, rounded up to SX126x filter
+#define NVMA_DEFAULT_GFSK_PREAMBLE              32      // bits
+#define NVMA_DEFAULT_GFSK_CRC                   4       // 2 B inverted (CCITT)
+#define NVMA_DEFAULT_GFSK_WHITENING             1       // Enabled
+#define NVMA_DEFAULT_GFSK_SYNC                  {0xC1, 0x94, 0xC1}
+#define NVMA_DEFAULT_GFSK_SYNC_LEN              3
+
+#define NVMA_LBT_MAX_ATTEMPTS                   16
+#define NVMA_LBT_MAX_BACKOFF_MS                 10000
+
+#define NVMA_LR_FHSS_MAX_CR                     3
+#define NVMA_LR_FHSS_MAX_BW                     9
+#define NVMA_LR_FHSS_MAX_GRID                   1
+#define NVMA_LR_FHSS_MAX_HOP_SEQ                511
+#define NVMA_LR_FHSS_HOP_SEQ_RANDOM             0xFFFF  // new random hop sequence for every packet
+
+#define NVMA_GFSK_MIN_BITRATE                   600
+#define NVMA_GFSK_MAX_BITRATE                   300000
+#define NVMA_GFSK_MIN_FDEV                      600
+#define NVMA_GFSK_MAX_FDEV                      200000
+#define NVMA_GFSK_MIN_BW                        4800
+#define NVMA_GFSK_MAX_BW                        467000
+#define NVMA_GFSK_MIN_PREAMBLE                  8
+#define NVMA_GFSK_MAX_CRC                       4       // RAL_GFSK_CRC_2_BYTES_INV, 3 B CRC not supported by SX126x
+#define NVMA_GFSK_MAX_SYNC_LEN                  8
 
 
 void NVMA_Init(void);
@@ -165,4 +225,44 @@ bool NVMA_Is_Valid_Baud(uint32_t baud);
 void NVMA_Set_RX_Format(uint8_t format);
 void NVMA_Get_RX_Format(uint8_t *format);
 
+void NVMA_Set_LR_CAD_Params(uint8_t symb, uint8_t detPeak, uint8_t detMin);
+void NVMA_Get_LR_CAD_Params(uint8_t *symb, uint8_t *detPeak, uint8_t *detMin);
+bool NVMA_Is_Valid_CAD_Symb(uint8_t symb);
+
+void NVMA_Set_LR_LBT_Params(uint8_t maxAttempts, uint16_t backoffMs);
+void NVMA_Get_LR_LBT_Params(uint8_t *maxAttempts, uint16_t *backoffMs);
+
+void NVMA_Set_LR_RX_Sniff(uint8_t sniff);
+void NVMA_Get_LR_RX_Sniff(uint8_t *sniff);
+
+void NVMA_Set_LR_FHSS_Params(uint8_t cr, uint8_t bw, uint8_t grid, uint16_t hopSeq);
+void NVMA_Get_LR_FHSS_Params(uint8_t *cr, uint8_t *bw, uint8_t *grid, uint16_t *hopSeq);
+
+void NVMA_Set_LR_FHSS_Sync(uint32_t sync);
+void NVMA_Get_LR_FHSS_Sync(uint32_t *sync);
+
+void NVMA_Set_RF_Modem(uint8_t modem);
+void NVMA_Get_RF_Modem(uint8_t *modem);
+
+void NVMA_Set_GFSK_Bitrate(uint32_t bitrate);
+void NVMA_Get_GFSK_Bitrate(uint32_t *bitrate);
+
+void NVMA_Set_GFSK_Fdev(uint32_t fdev);
+void NVMA_Get_GFSK_Fdev(uint32_t *fdev);
+
+void NVMA_Set_GFSK_BW(uint32_t bw);
+void NVMA_Get_GFSK_BW(uint32_t *bw);
+
+void NVMA_Set_GFSK_Preamble(uint16_t bits);
+void NVMA_Get_GFSK_Preamble(uint16_t *bits);
+
+void NVMA_Set_GFSK_CRC(uint8_t crc);
+void NVMA_Get_GFSK_CRC(uint8_t *crc);
+
+void NVMA_Set_GFSK_Whitening(uint8_t whitening);
+void NVMA_Get_GFSK_Whitening(uint8_t *whitening);
+
+void NVMA_Set_GFSK_SyncWord(const uint8_t *sync, uint8_t len);
+void NVMA_Get_GFSK_SyncWord(uint8_t *sync, uint8_t *len);
+
 #endif // NVMA_H
\ No newline at end of file
@@ -19,6 +19,15 @@
 
 #define MAX_SIZE_RADIO_BUFFER	253
 
+/* SPI transport to SX126x - payload/buffer parts go by DMA, task waits on notification */
+#define RF_SPI_WITH_DMA						1
+#define RF_SPI_DMA_MIN_LEN					16		// kratsi prenosy polling (rezie DMA je vetsi nez prenos)
+#define RF_SPI_TIMEOUT_MS					10		// DMA i polling, 255 B @ 4 MHz = ~0.5 ms
+
+/* BUSY wait - short commands spin, calibration/wake-up block on BUSY falling edge EXTI */
+#define RF_BUSY_SPIN_US						60		// bezny prikaz drzi BUSY < 10 us
+#define RF_BUSY_TIMEOUT_MS					50		// kalibrace vseho ~3.5 ms, pak se radio resetuje
+
 /* RX config */
 #define RF_RX_FREQUENCY							869525000+DEBUG_FREQ_OFFSET
 #define RF_RX_SF								RAL_LORA_SF9
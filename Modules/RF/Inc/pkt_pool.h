@@ -0,0 +1,52 @@
+/**
+ * @file pkt_pool.h
+ * @author your name (you@domain.com)
+ * @brief Static fixed-block pool for RF packets (replaces pvPortMalloc in RX/TX path)
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Each slot holds packet_info_t and the payload buffer, packet points into the slot.
+ * TX and RX have separate slot quotas so an RX burst can not block AT TX.
+ */
+#ifndef PKT_POOL_H
+#define PKT_POOL_H
+
+#include "main.h"
+#include "radio_user.h"
+
+#define PKT_POOL_DATA_SIZE      255                                         // max. LoRa payload
+#define PKT_POOL_TX_SLOTS       RF_TX_FIFO_SIZE                             // pokryva txPending v general_sys_cmd.c
+#define PKT_POOL_RX_SLOTS       3                                           // prijate pakety cekajici na UART
+#define PKT_POOL_SLOTS          (PKT_POOL_TX_SLOTS + PKT_POOL_RX_SLOTS)
+
+/**
+ * @brief Owner of pool slot - selects the quota
+ *
+ */
+typedef enum
+{
+    PKT_POOL_TX = 0,
+    PKT_POOL_RX,
+    PKT_POOL_OWNERS
+
+} pkt_pool_owner_e;
+
+/**
+ * @brief Pool statistics (AT+RF_POOL_STAT)
+ *
+ */
+typedef struct
+{
+    uint8_t     used[PKT_POOL_OWNERS];          // aktualne alokovane sloty
+    uint8_t     highWater[PKT_POOL_OWNERS];     // maximum alokovanych slotu
+    uint32_t    exhausted[PKT_POOL_OWNERS];     // neuspesne alokace (RX = zahozene pakety)
+
+} pkt_pool_stats_t;
+
+packet_info_t *pkt_pool_alloc(pkt_pool_owner_e owner);
+void pkt_pool_free(void *pkt);
+void pkt_pool_get_stats(pkt_pool_stats_t *stats);
+
+#endif // PKT_POOL_H
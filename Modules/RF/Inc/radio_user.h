@@ -15,18 +15,104 @@
 #define RF_HEART_BEAT_TIMEOUT_MS			(3*CONST_1_MIN)
 #define RF_EVENT_LED_TIMEOUT_MS				(100)
 
+/* Cached configuration - loraParam_tx/rx are reloaded from NVM only when dirty */
+#define RU_CFG_DIRTY_TX						(1u << 0)
+#define RU_CFG_DIRTY_RX						(1u << 1)
+#define RU_CFG_DIRTY_MODEM					(1u << 2)	// modem + GFSK parametry
+#define RU_CFG_DIRTY_ALL					(RU_CFG_DIRTY_TX | RU_CFG_DIRTY_RX | RU_CFG_DIRTY_MODEM)
+
+/* Parts of loraApplied known to match the SX126x registers */
+#define RU_APPLIED_PKT_TYPE					(1u << 0)
+#define RU_APPLIED_SYMB_TIMEOUT				(1u << 1)
+#define RU_APPLIED_FREQ						(1u << 2)
+#define RU_APPLIED_TX_CFG					(1u << 3)
+#define RU_APPLIED_MOD						(1u << 4)
+#define RU_APPLIED_PKT						(1u << 5)
+#define RU_APPLIED_SYNC						(1u << 6)
+#define RU_APPLIED_GFSK						(1u << 7)	// SX126x ma celou GFSK konfiguraci (LoRa bity pak neplati)
+
+/* Zpusob vysilani paketu v TX FIFO */
+#define RU_TX_MODE_NOW						0		// LoRa, hned
+#define RU_TX_MODE_LBT						1		// LoRa az po volnem CAD (listen-before-talk)
+#define RU_TX_MODE_LR_FHSS					2		// LR-FHSS, frekvence a vykon z LoRa TX konfigurace
+#define RU_TX_MODE_SCHED					3		// aktualni modem, set_tx z TIM2 compare v case sched_us
+
+/* Scheduled TX - payload se nahraje predem, v case slotu uz jen SetTx */
+#define RU_SCHED_MIN_LEAD_US				3000		// min. rezerva na standby + konfiguraci + payload
+#define RU_SCHED_PRELOAD_US				10000		// payload do SX126x az tolik pred slotem, do te doby bezi RX
+#define RU_SCHED_MAX_AHEAD_US				600000000u	// max. 10 min dopredu (TIM2 cas pretece po ~71 min)
+
 /*
  *
  */
-typedef struct
+typedef struct packet_info_s
 {
 	uint8_t 	*packet;
 	uint8_t		size;
-	uint16_t	rx_rssi;
+	uint16_t	id;			// TX: ID paketu pro +TXDONE
+	uint8_t		txMode;		// TX: RU_TX_MODE_*
+	int16_t		rx_rssi;	// RSSI paketu [dBm] (packet status, ne okamzite RSSI)
+	int8_t		rx_snr;		// SNR paketu [dB]
+	int16_t		rx_signal_rssi;	// RSSI signalu po despreadingu [dBm]
+	uint8_t		rx_cr;		// prijaty coding rate (ral_lora_cr_t), 0 = neznamy
+	bool		rx_crc;		// paket obsahoval CRC
+	uint32_t	rx_time_us;	// cas RX done IRQ [us] (TIM_GetTimestampUs)
+	uint32_t	sched_us;	// TX: cas spusteni pro RU_TX_MODE_SCHED [us]
 	uint8_t		rad;		//zatim nepotrebujem urcuje ktere radio patri k paketu
 }packet_info_t;
 
 
+/**
+ * @brief Continuous RX statistics (AT+RF_RX_STAT)
+ * 
+ */
+typedef struct
+{
+	uint32_t	packets;		// prijate pakety (RX done)
+	uint32_t	fastRearms;		// IRQ obslouzeno bez opusteni continuous RX
+	uint32_t	fullRearms;		// standby + konfigurace + set_rx
+	uint32_t	lastGapUs;		// posledni doba, kdy radio neposlouchalo
+	uint32_t	maxGapUs;
+
+}ru_rx_stats_t;
+
+
+/**
+ * @brief Listen-before-talk statistics (AT+RF_LBT_STAT)
+ * 
+ */
+typedef struct
+{
+	uint32_t	cadRuns;		// provedene CAD
+	uint32_t	busy;			// CAD detekoval aktivitu na kanalu
+	uint32_t	sent;			// pakety odvysilane po volnem CAD
+	uint32_t	dropped;		// pakety zahozene po max. poctu pokusu
+
+}ru_lbt_stats_t;
+
+
+/**
+ * @brief Scheduled TX statistics (AT+RF_SCHED_STAT)
+ * 
+ */
+typedef struct
+{
+	uint32_t	sent;			// SetTx odeslan v case slotu
+	uint32_t	late;			// paket na head az po case slotu - zahozen
+	uint32_t	deferred;		// SPI obsazene v ISR, SetTx poslal az RF task
+	int32_t		lastJitterUs;	// konec SetTx minus cas slotu
+	int32_t		maxJitterUs;
+
+}ru_sched_stats_t;
+
+/* RX sniff - okno RX musi cele padnout do preambule vysilace */
+#define RU_SNIFF_RX_SYMB					4		// symboly v RX okne pro detekci preambule
+#define RU_SNIFF_MARGIN_SYMB				2		// rezerva na konci preambule
+#define RU_SNIFF_WAKEUP_US					1000	// probuzeni ze sleep + start oscilatoru
+
+#define RU_LBT_MAX_BACKOFF_EXP				6		// okno backoffu roste max. na backoff * 2^5
+
+
 /**
  * @brief 
  * 
@@ -49,18 +135,33 @@ typedef enum
 
 
 void ru_radio_process_commands( RFCommands_e cmd,radio_context_t *ctx, const dataQueue_t *rxm);
-void ru_radio_process_IRQ( radio_context_t *ctx);
+void ru_radio_process_IRQ( radio_context_t *ctx, uint32_t irqTimeUs);
 radio_modes_e	ru_get_radio_last_status( radio_context_t	*ctx);
 bool ru_radio_send_packet(uint8_t *data, uint8_t size, radio_context_t	*ctx);
 bool ru_radioCleanAndStandby(ral_standby_cfg_t standbyMode, radio_context_t *ctx);
 bool ru_radioCleanAndSleep( bool onlySleep, radio_context_t *ctx);
 bool ru_radioInit(radio_context_t	*ctx);
+bool ru_radio_recover(radio_context_t *ctx, bool startRx);
+uint32_t ru_get_recoveries(void);
 void ru_sx1262_assign( radio_context_t	*ctx);
 void ru_radio_rfSwitch(bool tx,radio_context_t	*ctx);
 void ru_radio_start_CAD(radio_context_t	*ctx);
 void ru_radio_start_rx(radio_context_t	*ctx);
+void ru_radio_config_dirty(radio_context_t *ctx, uint8_t dirty);
+bool ru_load_radio_config_tx(ralf_params_lora_t *loraParam);
+bool ru_load_radio_config_rx(ralf_params_lora_t *loraParam);
+bool ru_load_radio_config_gfsk(ralf_params_gfsk_t *gfskParam, uint8_t *syncWord);
 uint32_t ru_calculate_toa_ms(uint8_t packetSize);
 uint32_t ru_calculate_symbol_time_us(void);
+bool ru_calculate_sniff_timing(const ralf_params_lora_t *loraParam, uint32_t *rxMs, uint32_t *sleepMs);
+const ru_rx_stats_t *ru_get_rx_stats(void);
+bool ru_tx_fifo_push(radio_context_t *ctx, packet_info_t *pkt);
+void ru_tx_fifo_flush(radio_context_t *ctx);
+const ru_lbt_stats_t *ru_get_lbt_stats(void);
+void ru_lbt_retry(radio_context_t *ctx);
+const ru_sched_stats_t *ru_get_sched_stats(void);
+void ru_sched_fire(radio_context_t *ctx);
+void ru_sched_preload(radio_context_t *ctx);
 
 
 #endif /* SEMTECHRADIO_RADIOUSER_H_ */
@@ -350,7 +350,7 @@ static inline ral_status_t ral_set_pkt_payload( const ral_t* radio, const uint8_
  *
  * @param [in] radio             Pointer to radio data structure
  * @param [in] max_size_in_bytes  Size of the application buffer - in bytes
- * @param [out] buffer           Pointer to the buffer to be filled with received data
+ * @param [out] buffer           Pointer to the buffer to be filled with received data, NULL = length only
  * @param [out] size_in_bytes     Size of the received buffer - in bytes
  *
  * @returns Operation status
@@ -361,6 +361,19 @@ static inline ral_status_t ral_get_pkt_payload( const ral_t* radio, uint16_t max
     return radio->driver.get_pkt_payload( radio->context, max_size_in_bytes, buffer, size_in_bytes );
 }
 
+/**
+ * @brief Get the length of the last received packet without reading its payload
+ *
+ * @param [in] radio             Pointer to radio data structure
+ * @param [out] size_in_bytes     Size of the received buffer - in bytes
+ *
+ * @returns Operation status
+ */
+static inline ral_status_t ral_get_rx_pkt_len( const ral_t* radio, uint16_t* size_in_bytes )
+{
+    return radio->driver.get_pkt_payload( radio->context, 0, NULL, size_in_bytes );
+}
+
 /**
  * @brief Get the current radio irq status
  *
@@ -127,6 +127,32 @@ typedef enum sx126x_hal_status_e
     SX126X_HAL_STATUS_ERROR = 3,
 } sx126x_hal_status_t;
 
+/**
+ * BUSY wait statistics (AT+RF_BUSY_STAT)
+ */
+typedef struct sx126x_hal_busy_stats_s
+{
+    uint32_t waits;         // BUSY byl pri kontrole high
+    uint32_t blocked;       // z toho task cekal na EXTI
+    uint32_t timeouts;      // BUSY se neuvolnil do RF_BUSY_TIMEOUT_MS
+    uint32_t last_us;
+    uint32_t max_us;
+} sx126x_hal_busy_stats_t;
+
+/**
+ * SPI transaction statistics (AT+RF_SPI_STAT)
+ */
+typedef struct sx126x_hal_spi_stats_s
+{
+    uint32_t transactions;      // NSS low/high ramce
+    uint32_t busy_checks;       // kontroly BUSY pred / po prikazu
+    uint32_t locks;             // ziskani SPI zamku (mutex)
+    uint32_t batches;
+    uint32_t errors;            // zrusene SPI prenosy (DMA timeout / chyba)
+    uint32_t last_batch_xfers;  // ramce v posledni davce
+    uint32_t last_batch_checks; // kontroly BUSY v posledni davce
+} sx126x_hal_spi_stats_t;
+
 
 /*
  * -----------------------------------------------------------------------------
@@ -187,6 +213,65 @@ sx126x_hal_status_t sx126x_hal_reset( const void* context );
  */
 sx126x_hal_status_t sx126x_hal_wakeup( const void* context );
 
+/**
+ * Radio command write from interrupt context, no data phase
+ *
+ * @param [in] context          Radio implementation parameters
+ * @param [in] command          Pointer to the buffer to be transmitted
+ * @param [in] command_length   Buffer size to be transmitted
+ *
+ * @returns Operation status, error if task holds the SPI
+ */
+sx126x_hal_status_t sx126x_hal_write_from_isr( const void* context, const uint8_t* command, const uint16_t command_length );
+
+/**
+ * Task is in the middle of SX126x SPI transaction
+ */
+bool sx126x_hal_in_use( void );
+
+/**
+ * Start SX126x command batch (one SPI lock, one BUSY check per command)
+ *
+ * @param [in] context          Radio implementation parameters
+ */
+void sx126x_hal_batch_begin( const void* context );
+
+/**
+ * Finish SX126x command batch - waits for BUSY of the last command
+ *
+ * @param [in] context          Radio implementation parameters
+ *
+ * @returns Operation status (error if any command of the batch failed)
+ */
+sx126x_hal_status_t sx126x_hal_batch_end( const void* context );
+
+/**
+ * SPI transaction statistics
+ */
+const sx126x_hal_spi_stats_t* sx126x_hal_get_spi_stats( void );
+
+/**
+ * BUSY falling edge (EXTI) - wakes the task blocked in BUSY wait
+ *
+ * @param [in] pin              EXTI pin (masked again when nobody waits)
+ */
+void sx126x_hal_busy_irq_from_isr( uint16_t pin );
+
+/**
+ * BUSY wait statistics
+ */
+const sx126x_hal_busy_stats_t* sx126x_hal_get_busy_stats( void );
+
+/**
+ * BUSY timeout or SPI error since last call - radio has to be reset (clears the flag)
+ */
+bool sx126x_hal_take_fault( void );
+
+/**
+ * Radio sequence failed above the HAL - RF task resets the radio
+ */
+void sx126x_hal_set_fault( void );
+
 #ifdef __cplusplus
 }
 #endif
@@ -601,6 +601,12 @@ ral_status_t ral_sx126x_get_pkt_payload( const void* context, uint16_t max_size_
         *size_in_bytes = radio_rx_buffer_status.pld_len_in_bytes;
     }
 
+    if( buffer == NULL )
+    {
+        // Length-only query - no payload transfer
+        return status;
+    }
+
     if( radio_rx_buffer_status.pld_len_in_bytes <= max_size_in_bytes )
     {
         status = ( ral_status_t ) sx126x_read_buffer( context, radio_rx_buffer_status.buffer_start_pointer, buffer,
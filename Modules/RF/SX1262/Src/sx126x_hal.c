@@ -12,10 +12,12 @@
 #include "main.h"
 #include "FreeRTOS.h"
 #include "task.h"
+#include "semphr.h"
 #include "string.h"
 #include <stddef.h>
 #include "spi.h"
 #include "ral_sx126x_bsp.h"
+#include "tim.h"
 
 /************************************************************************/
 /* Declaration importing objects                                        */
@@ -42,12 +44,37 @@ typedef enum radio_mode_e
 /* Definition local variables										   	*/
 /************************************************************************/
 static volatile radio_mode_t radio_mode = RADIO_SLEEP;
+static volatile bool spi_in_use = false;	// task prave komunikuje s SX126x - ISR nesmi na SPI
+
+// Zamek SPI mezi tasky - misto vTaskSuspendAll, behem DMA bezi ostatni tasky
+static SemaphoreHandle_t spi_mutex = NULL;
+static StaticSemaphore_t spi_mutex_buffer;
+static volatile TaskHandle_t spi_dma_task = NULL;	// task cekajici na dokonceni DMA
+static volatile bool spi_dma_error = false;
+
+static volatile TaskHandle_t busy_task = NULL;		// task cekajici na BUSY falling edge
+static volatile bool radio_fault = false;			// BUSY timeout / chyba SPI - radio je treba resetovat
+static sx126x_hal_busy_stats_t busy_stats;
+
+// Davka prikazu - jeden zamek, BUSY jen pred kazdym prikazem (ne dvakrat)
+static uint8_t batch_depth = 0;
+static TaskHandle_t batch_task = NULL;
+static bool batch_error = false;
+static bool batch_busy_pending = false;			// posledni prikaz davky jeste muze drzet BUSY
+static uint32_t batch_start_xfers;
+static uint32_t batch_start_checks;
+static sx126x_hal_spi_stats_t spi_stats;
 
 /************************************************************************/
 /* Declaration functions											   	*/
 /************************************************************************/
-void SX126xWaitOnBusy(GPIO_TypeDef *GPIOx, uint16_t pin);
-void sx126xCheckDeviceReady(const void* context );
+static bool sx126x_hal_wait_on_busy(const void* context);
+static void sx126x_hal_lock(void);
+static void sx126x_hal_unlock(void);
+static bool sx126x_hal_in_batch(void);
+static bool sx126x_hal_spi_transmit(radio_hal_cfg_t* spiDev, const uint8_t *buffer, uint16_t length);
+static bool sx126x_hal_spi_receive(radio_hal_cfg_t* spiDev, uint8_t *buffer, uint16_t length);
+bool sx126xCheckDeviceReady(const void* context );
 
 /************************************************************************/
 /* Definition functions                                                 */
@@ -69,55 +96,67 @@ void sx126xCheckDeviceReady(const void* context );
 sx126x_hal_status_t sx126x_hal_write(const void *context, const uint8_t *command, const uint16_t command_length, const uint8_t *data,
 		const uint16_t data_length)
 {
-	/* alokujeme statisky - tedy bereme to ze stacku - nikoliv z heapu */
-
 	radio_hal_cfg_t* spiDev;
 	spiDev = (radio_hal_cfg_t*) context;
+	bool batched = sx126x_hal_in_batch();
+	bool ok;
 
-
-	sx126xCheckDeviceReady( context);
-#if(FRAM_RF_SPI_WITH_DMA == 1)
-
-	if(SPI_RFFRAMGetLine(SPI_RFFRAM_Select_RF)==false)	_exit(785186);
-	if(SPI_RFFRAMTransmit_DMA_NoNSS(SPI_RFFRAM_Select_RF, (uint8_t*)command, command_length) != HAL_OK)
+	if (batched)
 	{
-		SPI_RFFRAMFreeLine(SPI_RFFRAM_Select_RF);
-		return SX126X_HAL_STATUS_ERROR;
+		// Po chybe v davce uz na BUSY znovu necekat
+		if (batch_error)	return SX126X_HAL_STATUS_ERROR;
 	}
-	if(data_length > 0)
+	else
 	{
-		if(SPI_RFFRAMTransmit_DMA_NoNSS(SPI_RFFRAM_Select_RF, (uint8_t*)data, data_length) != HAL_OK)
-		{
-			SPI_RFFRAMFreeLine(SPI_RFFRAM_Select_RF);
-			return SX126X_HAL_STATUS_ERROR;
-		}
+		sx126x_hal_lock();
 	}
 
-	if(SPI_RFFRAMFreeLine(SPI_RFFRAM_Select_RF) == false)	_exit(785185);
+	if (sx126xCheckDeviceReady(context) == false)
+	{
+		if (batched)	batch_error = true;
+		else			sx126x_hal_unlock();
+		return SX126X_HAL_STATUS_ERROR;
+	}
 
-#else
-	vTaskSuspendAll();
 	//Put NSS low to start spi transaction
 	HAL_GPIO_WritePin(spiDev->pin_NSS.port, spiDev->pin_NSS.pin, GPIO_PIN_RESET);
 
-	if(HAL_SPI_Transmit(spiDev->target,command,command_length,0xffff) != HAL_OK)					_exit(789);
-	if(data_length > 0)	if(HAL_SPI_Transmit(spiDev->target,data,data_length,0xffff) != HAL_OK) 	_exit(789);
+	ok = sx126x_hal_spi_transmit(spiDev, command, command_length);
+	if (ok && (data_length > 0))	ok = sx126x_hal_spi_transmit(spiDev, data, data_length);
 	
 	HAL_GPIO_WritePin(spiDev->pin_NSS.port, spiDev->pin_NSS.pin, GPIO_PIN_SET);
+	spi_stats.transactions++;
 
-	xTaskResumeAll();
-#endif
+	if (!ok)
+	{
+		if (batched)	batch_error = true;
+		else			sx126x_hal_unlock();
+		return SX126X_HAL_STATUS_ERROR;
+	}
 	
 	// 0x84 - SX126x_SET_SLEEP opcode. In sleep mode the radio dio is struck to 1 => do not test it
 	if( command[0] != 0x84 )
 	{
-		sx126xCheckDeviceReady(context );
+		if (batched)
+		{
+			// BUSY pocka az dalsi prikaz davky nebo sx126x_hal_batch_end
+			batch_busy_pending = true;
+			return SX126X_HAL_STATUS_OK;
+		}
+
+		if (sx126xCheckDeviceReady(context) == false)
+		{
+			sx126x_hal_unlock();
+			return SX126X_HAL_STATUS_ERROR;
+		}
 	}
 	else
 	{
 		radio_mode = RADIO_SLEEP;
+		batch_busy_pending = false;
 	}
 
+	if (!batched)	sx126x_hal_unlock();
 	return SX126X_HAL_STATUS_OK;
 }
 
@@ -137,48 +176,236 @@ sx126x_hal_status_t sx126x_hal_write(const void *context, const uint8_t *command
 sx126x_hal_status_t sx126x_hal_read(const void *context, const uint8_t *command, const uint16_t command_length, uint8_t *data,
 		const uint16_t data_length)
 {
-	sx126xCheckDeviceReady(context);
+	radio_hal_cfg_t* spiDev;
+	spiDev = (radio_hal_cfg_t*) context;
+	bool batched = sx126x_hal_in_batch();
+	bool ok;
 
-#if(FRAM_RF_SPI_WITH_DMA == 1)
-	
-	if(SPI_RFFRAMGetLine(SPI_RFFRAM_Select_RF)==false)	_exit(785186);
-	if(SPI_RFFRAMTransmit_DMA_NoNSS(SPI_RFFRAM_Select_RF, (uint8_t*)command, command_length) != HAL_OK)
+	if (batched)
+	{
+		if (batch_error)	return SX126X_HAL_STATUS_ERROR;
+	}
+	else
+	{
+		sx126x_hal_lock();
+	}
+
+	if (sx126xCheckDeviceReady(context) == false)
 	{
-		SPI_RFFRAMFreeLine(SPI_RFFRAM_Select_RF);
+		if (batched)	batch_error = true;
+		else			sx126x_hal_unlock();
 		return SX126X_HAL_STATUS_ERROR;
 	}
 
-	if(data_length > 0)
-	{	
-		if(SPI_RFFRAMReceive_DMA_NoNSS(SPI_RFFRAM_Select_RF,(uint8_t*) data, data_length) != HAL_OK) 	
-		{
-			SPI_RFFRAMFreeLine(SPI_RFFRAM_Select_RF);
-			return SX126X_HAL_STATUS_ERROR;
-		}
+	// Put NSS low to start spi transaction
+	HAL_GPIO_WritePin(spiDev->pin_NSS.port, spiDev->pin_NSS.pin, GPIO_PIN_RESET);
+
+	ok = sx126x_hal_spi_transmit(spiDev, command, command_length);
+	if (ok && (data_length > 0))	ok = sx126x_hal_spi_receive(spiDev, data, data_length);
+
+    // Put NSS high as the spi transaction is finished
+	HAL_GPIO_WritePin(spiDev->pin_NSS.port, spiDev->pin_NSS.pin, GPIO_PIN_SET);
+	spi_stats.transactions++;
+
+	if (!ok)
+	{
+		if (batched)	batch_error = true;
+		else			sx126x_hal_unlock();
+		return SX126X_HAL_STATUS_ERROR;
 	}
-	
-	if(SPI_RFFRAMFreeLine(SPI_RFFRAM_Select_RF) == false)	_exit(785185);
 
-#else
+	// Cteni nedrzi BUSY - cekani pred nim pokrylo predchozi prikaz
+	batch_busy_pending = false;
+
+	if (!batched)	sx126x_hal_unlock();
+    return SX126X_HAL_STATUS_OK;
+}
 
-	vTaskSuspendAll();
+/**
+ * Radio command write from interrupt context (scheduled TX)
+ *
+ * No scheduler calls and no BUSY wait - returns error when SPI is in use,
+ * radio sleeps or BUSY is high, caller then defers the command to the task.
+ * Radio must be awake (standby).
+ *
+ * @param [in] context          Radio implementation parameters
+ * @param [in] command          Pointer to the buffer to be transmitted
+ * @param [in] command_length   Buffer size to be transmitted
+ *
+ * @returns Operation status
+ */
+sx126x_hal_status_t sx126x_hal_write_from_isr(const void *context, const uint8_t *command, const uint16_t command_length)
+{
 	radio_hal_cfg_t* spiDev;
 	spiDev = (radio_hal_cfg_t*) context;
 
-	// Put NSS low to start spi transaction
+	if ((spi_in_use == true) || (radio_mode == RADIO_SLEEP))
+	{
+		return SX126X_HAL_STATUS_ERROR;
+	}
+
+	// V ISR se na BUSY neceka - radio jeste zpracovava predchozi prikaz, posle ho task
+	if (HAL_GPIO_ReadPin(spiDev->pin_BUSY.port, spiDev->pin_BUSY.pin) == GPIO_PIN_SET)
+	{
+		return SX126X_HAL_STATUS_ERROR;
+	}
+
 	HAL_GPIO_WritePin(spiDev->pin_NSS.port, spiDev->pin_NSS.pin, GPIO_PIN_RESET);
+	if (HAL_SPI_Transmit(spiDev->target,(uint8_t*)command,command_length,RF_SPI_TIMEOUT_MS) != HAL_OK)
+	{
+		HAL_GPIO_WritePin(spiDev->pin_NSS.port, spiDev->pin_NSS.pin, GPIO_PIN_SET);
+		HAL_SPI_Abort(spiDev->target);
+		spi_stats.errors++;
+		radio_fault = true;
+		return SX126X_HAL_STATUS_ERROR;
+	}
+	HAL_GPIO_WritePin(spiDev->pin_NSS.port, spiDev->pin_NSS.pin, GPIO_PIN_SET);
+	spi_stats.transactions++;
 
-	if(HAL_SPI_Transmit(spiDev->target,command,command_length,0xffff) != HAL_OK)				_exit(787);
+	return SX126X_HAL_STATUS_OK;
+}
 
-	if(data_length > 0)	if(HAL_SPI_Receive(spiDev->target,data,data_length,0xffff) != HAL_OK) 	_exit(788);
+/**
+ * @brief Task is in the middle of SX126x SPI transaction
+ * 
+ * @return true 
+ * @return false 
+ */
+bool sx126x_hal_in_use(void)
+{
+	return spi_in_use;
+}
 
-    // Put NSS high as the spi transaction is finished
-	HAL_GPIO_WritePin(spiDev->pin_NSS.port, spiDev->pin_NSS.pin, GPIO_PIN_SET);
+/**
+ * @brief Start command batch - following sx126x_hal_write / read of this task share
+ *        one SPI lock and wait on BUSY only before each command. Batches can nest.
+ * 
+ * @param context 
+ */
+void sx126x_hal_batch_begin(const void* context)
+{
+	UNUSED(context);
 
-	xTaskResumeAll();
+	// Pred startem scheduleru neni zamek - prikazy jdou jednotlive
+	if (xTaskGetSchedulerState() != taskSCHEDULER_RUNNING)
+	{
+		return;
+	}
 
-#endif
-    return SX126X_HAL_STATUS_OK;
+	if (sx126x_hal_in_batch())
+	{
+		batch_depth++;
+		return;
+	}
+
+	sx126x_hal_lock();
+	batch_task = xTaskGetCurrentTaskHandle();
+	batch_depth = 1;
+	batch_error = false;
+	batch_busy_pending = false;
+	batch_start_xfers = spi_stats.transactions;
+	batch_start_checks = spi_stats.busy_checks;
+	spi_stats.batches++;
+}
+
+/**
+ * @brief Finish command batch - waits for BUSY after the last command and releases SPI
+ * 
+ * @param context 
+ * @return sx126x_hal_status_t error if any command of the batch failed
+ */
+sx126x_hal_status_t sx126x_hal_batch_end(const void* context)
+{
+	bool error;
+
+	if (sx126x_hal_in_batch() == false)
+	{
+		return SX126X_HAL_STATUS_OK;
+	}
+
+	if (--batch_depth > 0)
+	{
+		return batch_error ? SX126X_HAL_STATUS_ERROR : SX126X_HAL_STATUS_OK;
+	}
+
+	if (batch_busy_pending && (batch_error == false))
+	{
+		batch_error = (sx126x_hal_wait_on_busy(context) == false);
+	}
+	batch_busy_pending = false;
+
+	spi_stats.last_batch_xfers = spi_stats.transactions - batch_start_xfers;
+	spi_stats.last_batch_checks = spi_stats.busy_checks - batch_start_checks;
+
+	error = batch_error;
+	batch_task = NULL;
+	sx126x_hal_unlock();
+
+	return error ? SX126X_HAL_STATUS_ERROR : SX126X_HAL_STATUS_OK;
+}
+
+/**
+ * @brief 
+ * 
+ * @return const sx126x_hal_spi_stats_t* 
+ */
+const sx126x_hal_spi_stats_t* sx126x_hal_get_spi_stats(void)
+{
+	return &spi_stats;
+}
+
+/**
+ * @brief BUSY falling edge - wake task blocked in sx126x_hal_busy_block
+ * 
+ * @param pin 
+ */
+void sx126x_hal_busy_irq_from_isr(uint16_t pin)
+{
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+	TaskHandle_t task = busy_task;
+
+	if (task == NULL)
+	{
+		// Nikdo neceka - hrany BUSY po kazdem prikazu nas nezajimaji
+		CLEAR_BIT(EXTI->IMR, pin);
+		return;
+	}
+
+	busy_task = NULL;
+	vTaskNotifyGiveFromISR(task, &xHigherPriorityTaskWoken);
+	portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+/**
+ * @brief 
+ * 
+ * @return const sx126x_hal_busy_stats_t* 
+ */
+const sx126x_hal_busy_stats_t* sx126x_hal_get_busy_stats(void)
+{
+	return &busy_stats;
+}
+
+/**
+ * @brief 
+ * 
+ * @return true BUSY timed out, radio needs reset
+ */
+bool sx126x_hal_take_fault(void)
+{
+	bool fault = radio_fault;
+
+	radio_fault = false;
+	return fault;
+}
+
+/**
+ * @brief 
+ * 
+ */
+void sx126x_hal_set_fault(void)
+{
+	radio_fault = true;
 }
 
 /**
@@ -194,6 +421,11 @@ sx126x_hal_status_t sx126x_hal_reset(const void *context)
 {
 	radio_hal_cfg_t* spiDev;
 	spiDev = (radio_hal_cfg_t*) context;
+	bool batched = sx126x_hal_in_batch();
+	bool ready;
+
+	// Behem resetu nesmi planovany SetTx z ISR na SPI
+	if (!batched)	sx126x_hal_lock();
 
 	HAL_GPIO_WritePin(spiDev->pin_NSS.port, spiDev->pin_NSS.pin, GPIO_PIN_SET);
 
@@ -204,10 +436,13 @@ sx126x_hal_status_t sx126x_hal_reset(const void *context)
 	HAL_GPIO_WritePin(spiDev->pin_RESET.port, spiDev->pin_RESET.pin, GPIO_PIN_SET);
 	osDelay(5);
 
-	sx126xCheckDeviceReady( context);
-
 	radio_mode = RADIO_AWAKE;
-	return SX126X_HAL_STATUS_OK;
+	ready = sx126x_hal_wait_on_busy(context);
+
+	if (!batched)			sx126x_hal_unlock();
+	else if (!ready)		batch_error = true;
+
+	return ready ? SX126X_HAL_STATUS_OK : SX126X_HAL_STATUS_ERROR;
 }
 
 /**
@@ -228,43 +463,295 @@ sx126x_hal_status_t sx126x_hal_wakeup( const void* context )
 //
 //		sx126x_hal_read( context, buf, 1, &status_local, 1 );
 //		return SX126X_HAL_STATUS_OK;
+	bool batched = sx126x_hal_in_batch();
+	bool ready;
 
-	sx126xCheckDeviceReady(context);
-	return SX126X_HAL_STATUS_OK;
+	// Probouzeni pres NSS - ISR nesmi mezitim na SPI
+	if (!batched)	sx126x_hal_lock();
+
+	ready = sx126xCheckDeviceReady(context);
+
+	if (!batched)			sx126x_hal_unlock();
+	else if (!ready)		batch_error = true;
+
+	return ready ? SX126X_HAL_STATUS_OK : SX126X_HAL_STATUS_ERROR;
+}
+
+
+/*
+ * Zamek SPI - pred startem scheduleru (init) jen priznak pro ISR
+ */
+static void sx126x_hal_lock(void)
+{
+	if (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING)
+	{
+		if (spi_mutex == NULL)
+		{
+			taskENTER_CRITICAL();
+			if (spi_mutex == NULL)
+			{
+				spi_mutex = xSemaphoreCreateMutexStatic(&spi_mutex_buffer);
+			}
+			taskEXIT_CRITICAL();
+		}
+		xSemaphoreTake(spi_mutex, portMAX_DELAY);
+	}
+	spi_in_use = true;
+	spi_stats.locks++;
+}
+
+
+/*
+ * Volajici task ma otevrenou davku (drzi zamek)
+ */
+static bool sx126x_hal_in_batch(void)
+{
+	return (batch_depth > 0) && (batch_task == xTaskGetCurrentTaskHandle());
+}
+
+
+/*
+ *
+ */
+static void sx126x_hal_unlock(void)
+{
+	spi_in_use = false;
+	if ((spi_mutex != NULL) && (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING))
+	{
+		xSemaphoreGive(spi_mutex);
+	}
+}
+
+
+/*
+ * Cekani na HAL_SPI_*CpltCallback / ErrorCallback
+ */
+static bool sx126x_hal_dma_wait(void)
+{
+	if ((ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(RF_SPI_TIMEOUT_MS)) == 0) || spi_dma_error)
+	{
+		spi_dma_task = NULL;
+		return false;
+	}
+	return true;
+}
+
+
+/*
+ * Chyba SPI - prenos zrusen, RF task radio resetuje
+ */
+static bool sx126x_hal_spi_failed(radio_hal_cfg_t* spiDev)
+{
+	HAL_SPI_Abort(spiDev->target);
+	spi_stats.errors++;
+	radio_fault = true;
+	return false;
+}
+
+
+/*
+ * Delsi bloky pres DMA - task se uspi a SPI bezi na pozadi
+ */
+static bool sx126x_hal_spi_transmit(radio_hal_cfg_t* spiDev, const uint8_t *buffer, uint16_t length)
+{
+#if(RF_SPI_WITH_DMA == 1)
+	if ((length >= RF_SPI_DMA_MIN_LEN) && (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING))
+	{
+		spi_dma_error = false;
+		(void)ulTaskNotifyTake(pdTRUE, 0);		// zapomenout starou notifikaci (BUSY EXTI)
+		spi_dma_task = xTaskGetCurrentTaskHandle();
+		if (HAL_SPI_Transmit_DMA(spiDev->target,(uint8_t*)buffer,length) != HAL_OK)
+		{
+			spi_dma_task = NULL;
+			return sx126x_hal_spi_failed(spiDev);
+		}
+		if (sx126x_hal_dma_wait() == false)
+		{
+			return sx126x_hal_spi_failed(spiDev);
+		}
+		return true;
+	}
+#endif
+	if (HAL_SPI_Transmit(spiDev->target,(uint8_t*)buffer,length,RF_SPI_TIMEOUT_MS) != HAL_OK)
+	{
+		return sx126x_hal_spi_failed(spiDev);
+	}
+	return true;
 }
 
 
 /*
  *
  */
-static void sx126x_hal_wait_on_busy(const void* context)
+static bool sx126x_hal_spi_receive(radio_hal_cfg_t* spiDev, uint8_t *buffer, uint16_t length)
+{
+#if(RF_SPI_WITH_DMA == 1)
+	if ((length >= RF_SPI_DMA_MIN_LEN) && (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING))
+	{
+		spi_dma_error = false;
+		(void)ulTaskNotifyTake(pdTRUE, 0);		// zapomenout starou notifikaci (BUSY EXTI)
+		spi_dma_task = xTaskGetCurrentTaskHandle();
+		if (HAL_SPI_Receive_DMA(spiDev->target,buffer,length) != HAL_OK)
+		{
+			spi_dma_task = NULL;
+			return sx126x_hal_spi_failed(spiDev);
+		}
+		if (sx126x_hal_dma_wait() == false)
+		{
+			return sx126x_hal_spi_failed(spiDev);
+		}
+		return true;
+	}
+#endif
+	if (HAL_SPI_Receive(spiDev->target,buffer,length,RF_SPI_TIMEOUT_MS) != HAL_OK)
+	{
+		return sx126x_hal_spi_failed(spiDev);
+	}
+	return true;
+}
+
+
+/*
+ * Dokonceni DMA - vzbudit task v sx126x_hal_dma_wait
+ */
+static void sx126x_hal_dma_done_from_isr(void)
+{
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+	TaskHandle_t task = spi_dma_task;
+
+	if (task != NULL)
+	{
+		spi_dma_task = NULL;
+		vTaskNotifyGiveFromISR(task, &xHigherPriorityTaskWoken);
+		portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+	}
+}
+
+
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+	sx126x_hal_dma_done_from_isr();
+}
+
+// HAL_SPI_Receive_DMA v master 2-lines rezimu bezi jako TransmitReceive
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+	sx126x_hal_dma_done_from_isr();
+}
+
+void HAL_SPI_RxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+	sx126x_hal_dma_done_from_isr();
+}
+
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+	spi_dma_error = true;
+	sx126x_hal_dma_done_from_isr();
+}
+
+
+/*
+ * Task ceka na BUSY falling edge v EXTI - CPU je volne pro ostatni tasky
+ */
+static void sx126x_hal_busy_block(radio_hal_cfg_t* spiDev)
+{
+	(void)ulTaskNotifyTake(pdTRUE, 0);		// zapomenout starou notifikaci
+	busy_task = xTaskGetCurrentTaskHandle();
+	WRITE_REG(EXTI->PR, spiDev->pin_BUSY.pin);
+	SET_BIT(EXTI->IMR, spiDev->pin_BUSY.pin);
+
+	// Hrana mohla prijit pred povolenim EXTI
+	if (HAL_GPIO_ReadPin(spiDev->pin_BUSY.port, spiDev->pin_BUSY.pin) == GPIO_PIN_SET)
+	{
+		(void)ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(RF_BUSY_TIMEOUT_MS));
+	}
+
+	CLEAR_BIT(EXTI->IMR, spiDev->pin_BUSY.pin);
+	busy_task = NULL;
+}
+
+
+/*
+ * Kratke cekani spinem, delsi (kalibrace, wake-up) blokuje task, pred startem scheduleru jen spin.
+ * Z ISR se nevola (sx126x_hal_write_from_isr kontroluje BUSY jen jednou).
+ * Vraci false po RF_BUSY_TIMEOUT_MS - nastavi radio_fault pro reset radia.
+ */
+static bool sx126x_hal_wait_on_busy(const void* context)
 {
 	radio_hal_cfg_t* spiDev;
 	spiDev = (radio_hal_cfg_t*) context;
+	uint32_t start;
+	uint32_t elapsed;
+	bool ready;
+
+	spi_stats.busy_checks++;
+	if (HAL_GPIO_ReadPin(spiDev->pin_BUSY.port, spiDev->pin_BUSY.pin) == GPIO_PIN_RESET)
+	{
+		return true;
+	}
 
-    while( HAL_GPIO_ReadPin(spiDev->pin_BUSY.port, spiDev->pin_BUSY.pin)==GPIO_PIN_SET );
+	start = TIM_GetTimestampUs();
+	while ((HAL_GPIO_ReadPin(spiDev->pin_BUSY.port, spiDev->pin_BUSY.pin) == GPIO_PIN_SET) &&
+		   ((TIM_GetTimestampUs() - start) < RF_BUSY_SPIN_US));
 
+	if (HAL_GPIO_ReadPin(spiDev->pin_BUSY.port, spiDev->pin_BUSY.pin) == GPIO_PIN_SET)
+	{
+		if ((__get_IPSR() == 0) && (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING))
+		{
+			busy_stats.blocked++;
+			sx126x_hal_busy_block(spiDev);
+		}
+		else
+		{
+			while ((HAL_GPIO_ReadPin(spiDev->pin_BUSY.port, spiDev->pin_BUSY.pin) == GPIO_PIN_SET) &&
+				   ((TIM_GetTimestampUs() - start) < (RF_BUSY_TIMEOUT_MS * 1000u)));
+		}
+	}
+
+	ready = (HAL_GPIO_ReadPin(spiDev->pin_BUSY.port, spiDev->pin_BUSY.pin) == GPIO_PIN_RESET);
+	elapsed = TIM_GetTimestampUs() - start;
+
+	busy_stats.waits++;
+	busy_stats.last_us = elapsed;
+	if (elapsed > busy_stats.max_us)
+	{
+		busy_stats.max_us = elapsed;
+	}
+	if (ready == false)
+	{
+		busy_stats.timeouts++;
+		radio_fault = true;
+	}
+
+	return ready;
 }
 
 
 /*
  *
  */
-void sx126xCheckDeviceReady(const void* context )
+bool sx126xCheckDeviceReady(const void* context )
 {
 	radio_hal_cfg_t* spiDev;
 	spiDev = (radio_hal_cfg_t*) context;
+	bool ready;
 
 	if( radio_mode != RADIO_SLEEP )
 	{
-		sx126x_hal_wait_on_busy(context);
+		ready = sx126x_hal_wait_on_busy(context);
 	}
 	else
 	{
 		// Busy is HIGH in sleep mode, wake-up the device
 		HAL_GPIO_WritePin(spiDev->pin_NSS.port, spiDev->pin_NSS.pin, GPIO_PIN_RESET);
-		sx126x_hal_wait_on_busy(context);
+		ready = sx126x_hal_wait_on_busy(context);
 		HAL_GPIO_WritePin(spiDev->pin_NSS.port, spiDev->pin_NSS.pin, GPIO_PIN_SET);
-		radio_mode = RADIO_AWAKE;
+		if (ready)
+		{
+			radio_mode = RADIO_AWAKE;
+		}
 	}
+
+	return ready;
 }
@@ -0,0 +1,144 @@
+/**
+ * @file pkt_pool.c
+ * @author your name (you@domain.com)
+ * @brief Static fixed-block pool for RF packets (replaces pvPortMalloc in RX/TX path)
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "pkt_pool.h"
+
+/**
+ * @brief One pool block - info must stay first (pkt_pool_free casts back)
+ *
+ */
+typedef struct
+{
+    packet_info_t   info;
+    uint8_t         data[PKT_POOL_DATA_SIZE];
+    uint8_t         owner;
+
+} pkt_pool_slot_t;
+
+static pkt_pool_slot_t pktPool[PKT_POOL_SLOTS];
+
+// Zasobnik volnych slotu - alokace i uvolneni v konstantnim case
+static uint8_t pktPoolFree[PKT_POOL_SLOTS];
+static uint8_t pktPoolFreeCount = 0;
+static bool pktPoolReady = false;
+
+static const uint8_t pktPoolQuota[PKT_POOL_OWNERS] = {PKT_POOL_TX_SLOTS, PKT_POOL_RX_SLOTS};
+static pkt_pool_stats_t pktPoolStats;
+
+
+/**
+ * @brief Fill free stack on first use (called with IRQ disabled)
+ *
+ */
+static void pkt_pool_init(void)
+{
+    for (uint8_t i = 0; i < PKT_POOL_SLOTS; i++)
+    {
+        pktPoolFree[i] = i;
+        pktPool[i].owner = PKT_POOL_OWNERS;
+    }
+    pktPoolFreeCount = PKT_POOL_SLOTS;
+    pktPoolReady = true;
+}
+
+/**
+ * @brief Take one slot from pool - callable from task and ISR
+ *
+ * @param owner PKT_POOL_TX / PKT_POOL_RX
+ * @return packet_info_t* with packet pointing to slot buffer, NULL if quota is used up
+ */
+packet_info_t *pkt_pool_alloc(pkt_pool_owner_e owner)
+{
+    uint32_t primask = __get_PRIMASK();
+    pkt_pool_slot_t *slot = NULL;
+
+    // Cortex-M0+ nema LDREX/STREX - kratka sekce se zakazanymi IRQ (jen par instrukci)
+    __disable_irq();
+    if (!pktPoolReady)
+    {
+        pkt_pool_init();
+    }
+
+    if ((pktPoolStats.used[owner] < pktPoolQuota[owner]) && (pktPoolFreeCount > 0))
+    {
+        slot = &pktPool[pktPoolFree[--pktPoolFreeCount]];
+        slot->owner = (uint8_t)owner;
+        pktPoolStats.used[owner]++;
+        if (pktPoolStats.used[owner] > pktPoolStats.highWater[owner])
+        {
+            pktPoolStats.highWater[owner] = pktPoolStats.used[owner];
+        }
+    }
+    else
+    {
+        pktPoolStats.exhausted[owner]++;
+    }
+    __set_PRIMASK(primask);
+
+    if (slot == NULL)
+    {
+        return NULL;
+    }
+
+    memset(&slot->info, 0, sizeof(slot->info));
+    slot->info.packet = slot->data;
+    return &slot->info;
+}
+
+/**
+ * @brief Return slot to pool - callable from task and ISR, NULL is ignored
+ *
+ * @param pkt packet_info_t from pkt_pool_alloc
+ */
+void pkt_pool_free(void *pkt)
+{
+    uint32_t primask;
+    uint32_t offset;
+    pkt_pool_slot_t *slot = (pkt_pool_slot_t *)pkt;
+
+    if (pkt == NULL)
+    {
+        return;
+    }
+
+    offset = (uint32_t)((uint8_t *)pkt - (uint8_t *)pktPool);
+    if (((uint8_t *)pkt < (uint8_t *)pktPool) || (offset >= sizeof(pktPool)) || ((offset % sizeof(pkt_pool_slot_t)) != 0))
+    {
+        _exit(21001);
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if ((slot->owner >= PKT_POOL_OWNERS) || (pktPoolFreeCount >= PKT_POOL_SLOTS))
+    {
+        // Dvojite uvolneni
+        __set_PRIMASK(primask);
+        _exit(21002);
+    }
+    pktPoolStats.used[slot->owner]--;
+    slot->owner = PKT_POOL_OWNERS;
+    pktPoolFree[pktPoolFreeCount++] = (uint8_t)(slot - pktPool);
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief
+ *
+ * @param stats
+ */
+void pkt_pool_get_stats(pkt_pool_stats_t *stats)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    *stats = pktPoolStats;
+    __set_PRIMASK(primask);
+}
@@ -15,10 +15,15 @@
 #include "ral_sx126x.h"
 #include "ral_defs.h"
 #include "sx126x.h"
+#include "sx126x_lr_fhss.h"
 #include "NVMA.h"
+#include "tim.h"
+#include "pkt_pool.h"
+#include "sx126x_hal.h"
 
 
 extern osMessageQId queueMainHandle;
+extern osMessageQId queueRadioHandle;
 
 #define LOG_TAG "[RADIO-USER]"
 #define LOG_LEVEL LOG_LEVEL_NONE
@@ -26,6 +31,31 @@ extern osMessageQId queueMainHandle;
 
 extern SPI_HandleTypeDef hspi1;
 
+static ru_rx_stats_t ru_rxStats;
+static ru_lbt_stats_t ru_lbtStats;
+static uint32_t ru_lbtRand = 0;
+static uint32_t ru_recoveries = 0;		// reset radia po BUSY timeoutu / chybe SPI
+
+/* Scheduled TX - ISR TIM2 potrebuje kontext RF tasku */
+static ru_sched_stats_t ru_schedStats;
+static radio_context_t *ru_schedCtx = NULL;
+static const uint8_t ru_schedSetTx[] = { 0x83, 0x00, 0x00, 0x00 };	// SX126X_SET_TX, bez timeoutu
+
+/* LR-FHSS - parametry a stav musi zustat platne po celou dobu TX (handle_hop z IRQ) */
+static ral_lr_fhss_params_t ru_lrFhssParams;
+static sx126x_lr_fhss_state_t ru_lrFhssState;
+static uint8_t ru_lrFhssSync[LR_FHSS_SYNC_WORD_BYTES];
+
+static void ru_lbt_start(radio_context_t *ctx);
+static bool ru_lr_fhss_start(radio_context_t *ctx);
+static bool ru_sched_start(radio_context_t *ctx);
+static bool ru_sched_load(radio_context_t *ctx);
+static uint32_t ru_lbt_random(void);
+static void ru_tx_fifo_pop(radio_context_t *ctx, bool sent);
+static void ru_tx_fifo_drop_head(radio_context_t *ctx);
+static void ru_radio_load_cached(radio_context_t *ctx, uint8_t which);
+static void ru_radio_prepare_tx(uint8_t *data, uint8_t size, radio_context_t *ctx);
+
 
 // Mapování hodnot 0-9 na šířky pásma v ral_lora_bw_t
 static const ral_lora_bw_t BW_MAP[] = {
@@ -55,91 +85,902 @@ ral_lora_bw_t get_lora_bw_from_user_value(uint8_t user_value)
         return RAL_LORA_BW_125_KHZ;
     }
 
-    return BW_MAP[user_value];
-}
+    return BW_MAP[user_value];
+}
+
+
+ral_lora_cr_t get_lora_cr_from_user_value(uint8_t user_value)
+{
+	switch (user_value)
+	{
+		case 45:
+			return RAL_LORA_CR_4_5;
+		case 46:
+			return RAL_LORA_CR_4_6;
+		case 47:
+			return RAL_LORA_CR_4_7;
+		case 48:
+			return RAL_LORA_CR_4_8;
+		default:
+			return RAL_LORA_CR_4_5; // Default to 4/5 if invalid value
+	}
+}
+
+
+/**
+ * @brief 
+ * 
+ * @param ctx 
+ */
+void ru_sx1262_assign( radio_context_t	*ctx)
+{
+	ctx->rfConfig.radioHal.TCXO_is_used = RF_USE_TCXO;
+
+	ctx->rfConfig.radioHal.AtomicActionEnter=vPortEnterCritical;
+	ctx->rfConfig.radioHal.AtomicActionExit=vPortExitCritical;
+	ctx->rfConfig.radioHal.pin_BUSY.port=SX1262_BUSY_GPIO_Port;
+	ctx->rfConfig.radioHal.pin_BUSY.pin=SX1262_BUSY_Pin;
+	ctx->rfConfig.radioHal.pin_RESET.port=SX1262_RESET_GPIO_Port;
+	ctx->rfConfig.radioHal.pin_RESET.pin=SX1262_RESET_Pin;
+	ctx->rfConfig.radioHal.pin_DIO1.port=SX1262_DIO1_GPIO_Port;
+	ctx->rfConfig.radioHal.pin_DIO1.pin=SX1262_DIO1_Pin;
+	ctx->rfConfig.radioHal.pin_NSS.port=SX1262_NSS_GPIO_Port;
+	ctx->rfConfig.radioHal.pin_NSS.pin=SX1262_NSS_Pin;
+	ctx->rfConfig.radioHal.pin_RF_SWITCH_1.port=SX1262_RF_SW_GPIO_Port;
+	ctx->rfConfig.radioHal.pin_RF_SWITCH_1.pin=SX1262_RF_SW_Pin;
+	ctx->rfConfig.radioHal.pin_RF_SWITCH_2.port=0;
+	ctx->rfConfig.radioHal.pin_RF_SWITCH_2.pin=0;
+	ctx->rfConfig.radioHal.TCXO_is_used=RF_USE_TCXO;
+	ctx->rfConfig.radioHal.DIO2_AS_RF_SWITCH=true;
+	ctx->rfConfig.radioHal.target=&hspi1;
+	//ctx->rfConfig.radioHal.AtomicActionEnter=vTaskSuspendAll;
+	//ctx->rfConfig.radioHal.AtomicActionExit=xTaskResumeAll;
+
+	/* config rx */
+	ctx->rfConfig.loraParam_rx.mod_params.bw=RF_RX_BW;
+	ctx->rfConfig.loraParam_rx.mod_params.cr=RF_RX_CODERATE;
+	ctx->rfConfig.loraParam_rx.mod_params.ldro=0;
+	ctx->rfConfig.loraParam_rx.mod_params.sf=RF_RX_SF;
+	ctx->rfConfig.loraParam_rx.output_pwr_in_dbm = 0;
+	ctx->rfConfig.loraParam_rx.rf_freq_in_hz=RF_RX_FREQUENCY;
+	ctx->rfConfig.loraParam_rx.pkt_params.crc_is_on=RF_RX_CRC_ON;
+	ctx->rfConfig.loraParam_rx.pkt_params.header_type=RAL_LORA_PKT_EXPLICIT;
+	ctx->rfConfig.loraParam_rx.pkt_params.invert_iq_is_on=RF_RX_IQ_INVERT;
+	ctx->rfConfig.loraParam_rx.pkt_params.preamble_len_in_symb=8;
+	ctx->rfConfig.loraParam_rx.pkt_params.pld_len_in_bytes = RF_RX_PACKET_LEN;
+	ctx->rfConfig.loraParam_rx.sync_word = 0x12;	
+
+	/* config tx */
+	ctx->rfConfig.loraParam_tx.mod_params.bw=RF_TX_BW;
+	ctx->rfConfig.loraParam_tx.mod_params.cr=RF_TX_CODERATE;
+	ctx->rfConfig.loraParam_tx.mod_params.ldro=0;
+	ctx->rfConfig.loraParam_tx.mod_params.sf=RF_TX_SF;
+	ctx->rfConfig.loraParam_tx.output_pwr_in_dbm = RF_TX_POWER;
+	ctx->rfConfig.loraParam_tx.rf_freq_in_hz=RF_TX_FREQUENCY;
+	ctx->rfConfig.loraParam_tx.pkt_params.crc_is_on=RF_TX_CRC_ON;
+	ctx->rfConfig.loraParam_tx.pkt_params.header_type=RAL_LORA_PKT_EXPLICIT;
+	ctx->rfConfig.loraParam_tx.pkt_params.invert_iq_is_on=RF_TX_IQ_INVERT;
+	ctx->rfConfig.loraParam_tx.pkt_params.preamble_len_in_symb=8;
+	ctx->rfConfig.loraParam_tx.pkt_params.pld_len_in_bytes = 1;
+	ctx->rfConfig.loraParam_tx.sync_word = 0x12;	
+
+
+	ctx->rfConfig.ralf = ( ralf_t ) RALF_SX126X_INSTANTIATE( &ctx->rfConfig.radioHal );
+
+	//Dorji module must have SW pin always high - we do it in init
+	if(ctx->rfConfig.radioHal.pin_RF_SWITCH_1.port != NULL)		HAL_GPIO_WritePin(ctx->rfConfig.radioHal.pin_RF_SWITCH_1.port, ctx->rfConfig.radioHal.pin_RF_SWITCH_1.pin, GPIO_PIN_SET);
+
+}
+
+/**
+ * @brief 
+ * 
+ * @return const ru_rx_stats_t* 
+ */
+const ru_rx_stats_t *ru_get_rx_stats(void)
+{
+	return &ru_rxStats;
+}
+
+/**
+ * @brief 
+ * 
+ * @param gapUs 
+ */
+static void ru_rx_stats_gap(uint32_t gapUs)
+{
+	ru_rxStats.lastGapUs = gapUs;
+	if (gapUs > ru_rxStats.maxGapUs)
+	{
+		ru_rxStats.maxGapUs = gapUs;
+	}
+}
+
+/**
+ * @brief Start transmission of the packet at FIFO head
+ * 
+ * @param ctx 
+ */
+static void ru_tx_fifo_start_head(radio_context_t *ctx)
+{
+	packet_info_t *pkt = ctx->txFifo.pkt[ctx->txFifo.head];
+
+	ctx->txFifo.toaMs = ru_calculate_toa_ms(pkt->size);
+	ctx->txFifo.lbtAttempt = 0;
+	if (pkt->txMode == RU_TX_MODE_LBT)
+	{
+		ru_radio_load_cached(ctx, RU_CFG_DIRTY_TX);
+		if (ctx->rfConfig.modem != RF_MODEM_LORA)
+		{
+			// CAD existuje jen pro LoRa
+			LOG_ERROR("LBT needs LoRa modem, packet %u dropped", pkt->id);
+			ru_tx_fifo_drop_head(ctx);
+			return;
+		}
+		// Vysila se az po volnem CAD
+		ru_lbt_start(ctx);
+		return;
+	}
+
+	if (pkt->txMode == RU_TX_MODE_SCHED)
+	{
+		if (ru_sched_start(ctx) == false)
+		{
+			// Slot uz probehl - pozdni paket by rusil cizi slot
+			LOG_ERROR("Scheduled TX late, packet %u dropped", pkt->id);
+			ru_tx_fifo_drop_head(ctx);
+			return;
+		}
+		LOG_INFO("RF data scheduled: id %u, %d B at %lu us", pkt->id, pkt->size, pkt->sched_us);
+		return;
+	}
+
+	if (pkt->txMode == RU_TX_MODE_LR_FHSS)
+	{
+		if (ru_lr_fhss_start(ctx) == false)
+		{
+			// Paket nelze poslat (delka / chyba SX126x)
+			ru_tx_fifo_drop_head(ctx);
+			return;
+		}
+	}
+	else
+	{
+		ru_radio_send_packet(pkt->packet, pkt->size, ctx);
+	}
+
+	HW_LED_RF_EVENT_ON();
+	osTimerStart(ctx->timers.rfEventLedTimer.timer,pdMS_TO_TICKS(RF_EVENT_LED_TIMEOUT_MS));
+
+	LOG_INFO("RF data sent: id %u, %d B, TOA: %lu ms", pkt->id, pkt->size, ctx->txFifo.toaMs);
+}
+
+/**
+ * @brief Remove FIFO head and report it to main task
+ * 
+ * @param ctx 
+ * @param sent false = paket zahozen (flush)
+ */
+static void ru_tx_fifo_pop(radio_context_t *ctx, bool sent)
+{
+	dataQueue_t txm;
+	packet_info_t *pkt = ctx->txFifo.pkt[ctx->txFifo.head];
+
+	txm.cmd = CMD_MAIN_RF_TX_DONE;
+	txm.ptr = NULL;
+	txm.data = sent ? ctx->txFifo.doneUs : 0;
+	txm.tmp_16 = pkt->id;
+	txm.tmp_32 = sent ? ctx->txFifo.toaMs : 0;
+	txm.tmp_bool = sent;
+
+	// Slot vratit driv, nez main task uvolni misto v txPending
+	pkt_pool_free(pkt);
+	ctx->txFifo.pkt[ctx->txFifo.head] = NULL;
+	ctx->txFifo.head = (uint8_t)((ctx->txFifo.head + 1) % RF_TX_FIFO_SIZE);
+	ctx->txFifo.count--;
+
+	xQueueSend(queueMainHandle,&txm,portMAX_DELAY);
+}
+
+/**
+ * @brief Drop FIFO head as failed and continue with next packet or RX
+ * 
+ * @param ctx 
+ */
+static void ru_tx_fifo_drop_head(radio_context_t *ctx)
+{
+	ru_tx_fifo_pop(ctx, false);
+	if (ctx->txFifo.count > 0)
+	{
+		ru_tx_fifo_start_head(ctx);
+	}
+	else
+	{
+		ru_radio_start_rx(ctx);
+	}
+}
+
+/**
+ * @brief Queue packet for TX, FIFO takes ownership of pkt on success
+ * 
+ * @param ctx 
+ * @param pkt 
+ * @return true 
+ * @return false FIFO full, pkt not taken
+ */
+bool ru_tx_fifo_push(radio_context_t *ctx, packet_info_t *pkt)
+{
+	if (ctx->txFifo.count >= RF_TX_FIFO_SIZE)
+	{
+		LOG_ERROR("TX FIFO full, packet %u dropped", pkt->id);
+		return false;
+	}
+
+	ctx->txFifo.pkt[(ctx->txFifo.head + ctx->txFifo.count) % RF_TX_FIFO_SIZE] = pkt;
+	ctx->txFifo.count++;
+
+	// Radio uz vysila - paket se spusti z TX done
+	if (ctx->txFifo.count == 1)
+	{
+		ru_radioCleanAndStandby(RAL_STANDBY_CFG_XOSC,ctx);
+		ru_tx_fifo_start_head(ctx);
+	}
+
+	return true;
+}
+
+/**
+ * @brief Drop all queued packets (radio off / CW), each is reported as failed
+ * 
+ * @param ctx 
+ */
+void ru_tx_fifo_flush(radio_context_t *ctx)
+{
+	if (ctx->txFifo.schedArmed || ctx->txFifo.schedWaiting)
+	{
+		// Nejdriv zrusit compare - ISR uz pak SPI nepouzije
+		TIM_CancelSchedule();
+		ctx->txFifo.schedArmed = false;
+		ctx->txFifo.schedWaiting = false;
+	}
+
+	ctx->txFifo.lbtCad = false;
+	ctx->txFifo.lbtWaiting = false;
+	osTimerStop(ctx->timers.rfLbtTimer.timer);
+
+	if (ctx->txFifo.lrFhss)
+	{
+		// Preruseny LR-FHSS TX - vypnout hopping v SX126x
+		ral_lr_fhss_handle_tx_done(&ctx->rfConfig.ralf.ral, &ru_lrFhssParams, &ru_lrFhssState);
+		ctx->txFifo.lrFhss = false;
+	}
+
+	while (ctx->txFifo.count > 0)
+	{
+		ru_tx_fifo_pop(ctx, false);
+	}
+}
+
+/**
+ * @brief xorshift32 for LBT backoff, seeded from the MCU unique ID
+ * 
+ * @return uint32_t 
+ */
+static uint32_t ru_lbt_random(void)
+{
+	if (ru_lbtRand == 0)
+	{
+		// Kazdy dongle jina sekvence, jinak by se backoff sousedu synchronizoval
+		ru_lbtRand = HAL_GetUIDw0() ^ HAL_GetUIDw1() ^ HAL_GetUIDw2() ^ HAL_GetTick();
+		if (ru_lbtRand == 0)
+		{
+			ru_lbtRand = 0x2545F491u;
+		}
+	}
+
+	ru_lbtRand ^= ru_lbtRand << 13;
+	ru_lbtRand ^= ru_lbtRand >> 17;
+	ru_lbtRand ^= ru_lbtRand << 5;
+	return ru_lbtRand;
+}
+
+/**
+ * @brief 
+ * 
+ * @return const ru_lbt_stats_t* 
+ */
+const ru_lbt_stats_t *ru_get_lbt_stats(void)
+{
+	return &ru_lbtStats;
+}
+
+/**
+ * @brief Load head packet and TX params, then run CAD on the TX channel
+ * 
+ * @param ctx 
+ */
+static void ru_lbt_start(radio_context_t *ctx)
+{
+	ral_t* ral = &ctx->rfConfig.ralf.ral;
+	packet_info_t *pkt = ctx->txFifo.pkt[ctx->txFifo.head];
+	ral_lora_cad_params_t cadPar;
+	ral_status_t ret = RAL_STATUS_OK;
+	uint8_t symb;
+
+	ru_radioCleanAndStandby(RAL_STANDBY_CFG_XOSC, ctx);
+
+	// Payload a TX parametry se nahraji pred CAD - pri volnem kanalu uz jen set_tx
+	ru_radio_prepare_tx(pkt->packet, pkt->size, ctx);
+	ret += ral_set_dio_irq_params(ral, RAL_IRQ_TX_DONE | RAL_IRQ_CAD_DONE | RAL_IRQ_CAD_OK);
+
+	NVMA_Get_LR_CAD_Params(&symb, &cadPar.cad_det_peak_in_symb, &cadPar.cad_det_min_in_symb);
+	switch (symb)
+	{
+		case 1:		cadPar.cad_symb_nb = RAL_LORA_CAD_01_SYMB; break;
+		case 2:		cadPar.cad_symb_nb = RAL_LORA_CAD_02_SYMB; break;
+		case 8:		cadPar.cad_symb_nb = RAL_LORA_CAD_08_SYMB; break;
+		case 16:	cadPar.cad_symb_nb = RAL_LORA_CAD_16_SYMB; break;
+		default:	cadPar.cad_symb_nb = RAL_LORA_CAD_04_SYMB; break;
+	}
+	cadPar.cad_timeout_in_ms = 0;
+	cadPar.cad_exit_mode = RAL_LORA_CAD_ONLY;
+
+	ret += ral_set_lora_cad_params(ral, &cadPar);
+	ret += ral_set_lora_cad(ral);
+
+	if(ret != RAL_STATUS_OK)
+	{
+		// Paket konci jako +TXFAIL, chybu SX126x resi RF task resetem radia
+		LOG_ERROR("LBT CAD start failed, packet %u dropped", pkt->id);
+		ru_lbtStats.dropped++;
+		ru_tx_fifo_drop_head(ctx);
+		return;
+	}
+
+	ru_lbtStats.cadRuns++;
+	ctx->txFifo.lbtCad = true;
+	ctx->rfConfig.lastMode = RF_MODE_CAD;
+}
+
+/**
+ * @brief CAD finished for LBT packet - transmit or back off
+ * 
+ * @param ctx 
+ * @param irqSet 
+ */
+static void ru_lbt_cad_done(radio_context_t *ctx, ral_irq_t irqSet)
+{
+	ral_t* ral = &ctx->rfConfig.ralf.ral;
+	uint8_t maxAttempts;
+	uint16_t backoffMs;
+	uint32_t window;
+	uint32_t delayMs;
+
+	ctx->txFifo.lbtCad = false;
+	ral_clear_irq_status(ral, RAL_IRQ_ALL);
+
+	if (((irqSet & RAL_IRQ_CAD_DONE) == RAL_IRQ_CAD_DONE) && ((irqSet & RAL_IRQ_CAD_OK) != RAL_IRQ_CAD_OK))
+	{
+		// Kanal volny - payload i parametry uz jsou v SX126x
+		ru_radio_rfSwitch(true,ctx);
+		ral_set_tx(ral);
+		ctx->rfConfig.lastMode = RF_MODE_TX;
+		ru_lbtStats.sent++;
+
+		HW_LED_RF_EVENT_ON();
+		osTimerStart(ctx->timers.rfEventLedTimer.timer,pdMS_TO_TICKS(RF_EVENT_LED_TIMEOUT_MS));
+		return;
+	}
+
+	ru_lbtStats.busy++;
+	ctx->txFifo.lbtAttempt++;
+	NVMA_Get_LR_LBT_Params(&maxAttempts, &backoffMs);
+
+	if (ctx->txFifo.lbtAttempt >= maxAttempts)
+	{
+		LOG_INFO("LBT: channel busy, packet %u dropped", ctx->txFifo.pkt[ctx->txFifo.head]->id);
+		ru_lbtStats.dropped++;
+		ru_tx_fifo_drop_head(ctx);
+		return;
+	}
+
+	// Nahodny exponencialni backoff <1, backoff * 2^(pokus-1)>, mezitim prijem
+	window = (uint32_t)backoffMs << ((ctx->txFifo.lbtAttempt <= RU_LBT_MAX_BACKOFF_EXP) ? (ctx->txFifo.lbtAttempt - 1) : (RU_LBT_MAX_BACKOFF_EXP - 1));
+	delayMs = 1 + (ru_lbt_random() % window);
+
+	ru_radio_start_rx(ctx);
+	ctx->txFifo.lbtWaiting = true;
+	xTimerChangePeriod(ctx->timers.rfLbtTimer.timer, pdMS_TO_TICKS(delayMs), 0);
+	xTimerStart(ctx->timers.rfLbtTimer.timer, 0);
+}
+
+/**
+ * @brief Backoff expired - RF task context
+ * 
+ * @param ctx 
+ */
+void ru_lbt_retry(radio_context_t *ctx)
+{
+	if ((ctx->txFifo.lbtWaiting == false) || (ctx->txFifo.count == 0))
+	{
+		return;
+	}
+
+	ctx->txFifo.lbtWaiting = false;
+	ru_lbt_start(ctx);
+}
+
+/**
+ * @brief 
+ * 
+ * @return const ru_sched_stats_t* 
+ */
+const ru_sched_stats_t *ru_get_sched_stats(void)
+{
+	return &ru_schedStats;
+}
+
+/**
+ * @brief SetTx sent for scheduled FIFO head - ISR or RF task context
+ * 
+ * @param ctx 
+ */
+static void ru_sched_launched(radio_context_t *ctx)
+{
+	packet_info_t *pkt = ctx->txFifo.pkt[ctx->txFifo.head];
+	int32_t jitter = (int32_t)(TIM_GetTimestampUs() - pkt->sched_us);
+
+	ctx->txFifo.schedArmed = false;
+	ru_schedStats.sent++;
+	ru_schedStats.lastJitterUs = jitter;
+	if (jitter > ru_schedStats.maxJitterUs)
+	{
+		ru_schedStats.maxJitterUs = jitter;
+	}
+}
+
+/**
+ * @brief TIM2 compare reached slot time - send SetTx directly from ISR
+ * 
+ */
+static void ru_sched_fire_isr(void)
+{
+	radio_context_t *ctx = ru_schedCtx;
+	dataQueue_t txm;
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	if ((ctx == NULL) || (ctx->txFifo.schedArmed == false))
+	{
+		return;
+	}
+
+	if (sx126x_hal_write_from_isr(&ctx->rfConfig.radioHal, ru_schedSetTx, sizeof(ru_schedSetTx)) == SX126X_HAL_STATUS_OK)
+	{
+		ru_sched_launched(ctx);
+		return;
+	}
+
+	// SPI obsazene nebo BUSY vysoko - SetTx posle RF task hned jak to pujde
+	txm.cmd = CMD_RF_SCHED_FIRE;
+	txm.ptr = NULL;
+	xQueueSendToFrontFromISR(queueRadioHandle, &txm, &xHigherPriorityTaskWoken);
+	portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+/**
+ * @brief Slot time reached while SPI was busy - RF task context
+ * 
+ * @param ctx 
+ */
+void ru_sched_fire(radio_context_t *ctx)
+{
+	if (ctx->txFifo.schedArmed == false)
+	{
+		// Mezitim flush
+		return;
+	}
+
+	ral_set_tx(&ctx->rfConfig.ralf.ral);
+	ru_schedStats.deferred++;
+	ru_sched_launched(ctx);
+}
+
+/**
+ * @brief TIM2 compare RU_SCHED_PRELOAD_US before slot - wake RF task to load the payload
+ * 
+ */
+static void ru_sched_preload_isr(void)
+{
+	radio_context_t *ctx = ru_schedCtx;
+	dataQueue_t txm;
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	if ((ctx == NULL) || (ctx->txFifo.schedWaiting == false))
+	{
+		return;
+	}
+
+	txm.cmd = CMD_RF_SCHED_PRELOAD;
+	txm.ptr = NULL;
+	xQueueSendToFrontFromISR(queueRadioHandle, &txm, &xHigherPriorityTaskWoken);
+	portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+/**
+ * @brief Slot is RU_SCHED_PRELOAD_US ahead - stop RX and load FIFO head, RF task context
+ * 
+ * @param ctx 
+ */
+void ru_sched_preload(radio_context_t *ctx)
+{
+	if (ctx->txFifo.schedWaiting == false)
+	{
+		// Mezitim flush
+		return;
+	}
+
+	ctx->txFifo.schedWaiting = false;
+	if (ru_sched_load(ctx) == false)
+	{
+		LOG_ERROR("Scheduled TX late, packet %u dropped", ctx->txFifo.pkt[ctx->txFifo.head]->id);
+		ru_tx_fifo_drop_head(ctx);
+	}
+}
+
+/**
+ * @brief Wait for FIFO head slot - far slot keeps RX running until preload, near slot is loaded now
+ * 
+ * @param ctx 
+ * @return true 
+ * @return false slot time already passed
+ */
+static bool ru_sched_start(radio_context_t *ctx)
+{
+	packet_info_t *pkt = ctx->txFifo.pkt[ctx->txFifo.head];
+	int32_t remainUs = (int32_t)(pkt->sched_us - TIM_GetTimestampUs());
+
+	if (remainUs <= 0)
+	{
+		ru_schedStats.late++;
+		return false;
+	}
+
+	if (remainUs > RU_SCHED_PRELOAD_US)
+	{
+		// Do preloadu prijimat - radio neni az 10 min hluche
+		ru_radio_start_rx(ctx);
+		ru_schedCtx = ctx;
+		ctx->txFifo.schedWaiting = true;
+		TIM_ScheduleAtUs(pkt->sched_us - RU_SCHED_PRELOAD_US, ru_sched_preload_isr);
+		return true;
+	}
+
+	return ru_sched_load(ctx);
+}
+
+/**
+ * @brief Load FIFO head into SX126x (standby XOSC) and arm TIM2 compare for its slot
+ * 
+ * @param ctx 
+ * @return true 
+ * @return false slot time already passed
+ */
+static bool ru_sched_load(radio_context_t *ctx)
+{
+	ral_t* ral = &ctx->rfConfig.ralf.ral;
+	packet_info_t *pkt = ctx->txFifo.pkt[ctx->txFifo.head];
+
+	// XOSC bezi - SetTx startuje bez nabehu oscilatoru
+	ru_radioCleanAndStandby(RAL_STANDBY_CFG_XOSC, ctx);
+	ral_set_dio_irq_params(ral, RAL_IRQ_TX_DONE);
+	ru_radio_prepare_tx(pkt->packet, pkt->size, ctx);
+	ru_radio_rfSwitch(true, ctx);
+	ctx->rfConfig.lastMode = RF_MODE_TX;
+
+	if ((int32_t)(pkt->sched_us - TIM_GetTimestampUs()) <= 0)
+	{
+		ru_schedStats.late++;
+		return false;
+	}
+
+	ru_schedCtx = ctx;
+	ctx->txFifo.schedArmed = true;
+	TIM_ScheduleAtUs(pkt->sched_us, ru_sched_fire_isr);
+
+	HW_LED_RF_EVENT_ON();
+	osTimerStart(ctx->timers.rfEventLedTimer.timer,pdMS_TO_TICKS(RF_EVENT_LED_TIMEOUT_MS));
+
+	return true;
+}
+
+/**
+ * @brief Configure SX126x for LR-FHSS, write frame + hop table head for FIFO head and start TX
+ * 
+ * @param ctx 
+ * @return true 
+ * @return false frame could not be built (payload too long / SPI error)
+ */
+static bool ru_lr_fhss_start(radio_context_t *ctx)
+{
+	ral_t* ral = &ctx->rfConfig.ralf.ral;
+	packet_info_t *pkt = ctx->txFifo.pkt[ctx->txFifo.head];
+	ral_status_t ret = RAL_STATUS_OK;
+	uint8_t cr;
+	uint8_t bw;
+	uint8_t grid;
+	uint16_t hopSeq;
+	uint32_t sync;
+	uint16_t seqCount;
+
+	ru_radioCleanAndStandby(RAL_STANDBY_CFG_XOSC, ctx);
+
+	// Stredni frekvence a vykon podle LoRa TX konfigurace
+	ru_radio_load_cached(ctx, RU_CFG_DIRTY_TX);
+	NVMA_Get_LR_FHSS_Params(&cr, &bw, &grid, &hopSeq);
+	NVMA_Get_LR_FHSS_Sync(&sync);
+
+	ru_lrFhssSync[0] = (uint8_t)(sync >> 24);
+	ru_lrFhssSync[1] = (uint8_t)(sync >> 16);
+	ru_lrFhssSync[2] = (uint8_t)(sync >> 8);
+	ru_lrFhssSync[3] = (uint8_t)sync;
+
+	ru_lrFhssParams.lr_fhss_params.sync_word = ru_lrFhssSync;
+	ru_lrFhssParams.lr_fhss_params.modulation_type = LR_FHSS_V1_MODULATION_TYPE_GMSK_488;
+	ru_lrFhssParams.lr_fhss_params.cr = (lr_fhss_v1_cr_t)cr;
+	ru_lrFhssParams.lr_fhss_params.grid = (lr_fhss_v1_grid_t)grid;
+	ru_lrFhssParams.lr_fhss_params.bw = (lr_fhss_v1_bw_t)bw;
+	ru_lrFhssParams.lr_fhss_params.enable_hopping = true;
+	// Jako LoRaWAN - 3 hlavicky pro CR 1/3 a 1/2, jinak 2
+	ru_lrFhssParams.lr_fhss_params.header_count = (cr >= LR_FHSS_V1_CR_1_2) ? 3 : 2;
+	ru_lrFhssParams.center_frequency_in_hz = ctx->rfConfig.loraParam_tx.rf_freq_in_hz;
+	ru_lrFhssParams.device_offset = 0;
+
+	// Grid 25 kHz ma mene sekvenci nez 3.9 kHz
+	seqCount = (uint16_t)ral_lr_fhss_get_hop_sequence_count(ral, &ru_lrFhssParams);
+	if (hopSeq == NVMA_LR_FHSS_HOP_SEQ_RANDOM)
+	{
+		hopSeq = (uint16_t)(ru_lbt_random() % seqCount);
+	}
+	else
+	{
+		hopSeq = (uint16_t)(hopSeq % seqCount);
+	}
+
+	// LR-FHSS prepise typ paketu i mod/pkt parametry - LoRa se pak nastavi cela znovu
+	ctx->rfConfig.appliedValid = 0;
+
+	ret += ral_lr_fhss_init(ral, &ru_lrFhssParams);
+	ret += ral_set_rf_freq(ral, ru_lrFhssParams.center_frequency_in_hz);
+	ret += ral_set_tx_cfg(ral, ctx->rfConfig.loraParam_tx.output_pwr_in_dbm, ru_lrFhssParams.center_frequency_in_hz);
+	ret += ral_set_dio_irq_params(ral, RAL_IRQ_TX_DONE | RAL_IRQ_LR_FHSS_HOP);
+	ret += ral_lr_fhss_build_frame(ral, &ru_lrFhssParams, &ru_lrFhssState, hopSeq, pkt->packet, pkt->size);
+
+	if (ret != RAL_STATUS_OK)
+	{
+		LOG_ERROR("LR-FHSS: frame build failed, packet %u dropped", pkt->id);
+		return false;
+	}
+
+	ral_lr_fhss_get_time_on_air_in_ms(ral, &ru_lrFhssParams, pkt->size, &ctx->txFifo.toaMs);
+
+	ru_radio_rfSwitch(true,ctx);
+	ral_set_tx(ral);
+
+	ctx->txFifo.lrFhss = true;
+	ctx->rfConfig.lastMode = RF_MODE_TX;
+
+	LOG_INFO("LR-FHSS TX: CR %u, BW %u, grid %u, hop seq %u", cr, bw, grid, hopSeq);
+
+	return true;
+}
+
+/**
+ * @brief Mark cached TX/RX parameters as changed in NVM - RF task context
+ * 
+ * @param ctx 
+ * @param dirty RU_CFG_DIRTY_TX / RU_CFG_DIRTY_RX
+ */
+void ru_radio_config_dirty(radio_context_t *ctx, uint8_t dirty)
+{
+	ctx->rfConfig.cfgDirty |= dirty;
+}
+
+/**
+ * @brief Reload cached parameters from NVM only if they were marked dirty
+ * 
+ * @param ctx 
+ * @param which RU_CFG_DIRTY_TX / RU_CFG_DIRTY_RX
+ */
+static void ru_radio_load_cached(radio_context_t *ctx, uint8_t which)
+{
+	if (ctx->rfConfig.cfgDirty & RU_CFG_DIRTY_MODEM)
+	{
+		// Modem plati pro TX i RX
+		NVMA_Get_RF_Modem(&ctx->rfConfig.modem);
+		ru_load_radio_config_gfsk(&ctx->rfConfig.gfskParam, ctx->rfConfig.gfskSync);
+		ctx->rfConfig.appliedValid &= (uint8_t)~RU_APPLIED_GFSK;
+		ctx->rfConfig.cfgDirty &= (uint8_t)~RU_CFG_DIRTY_MODEM;
+	}
+
+	if ((which & RU_CFG_DIRTY_TX) && (ctx->rfConfig.cfgDirty & RU_CFG_DIRTY_TX))
+	{
+		ru_load_radio_config_tx(&ctx->rfConfig.loraParam_tx);
+		ctx->rfConfig.cfgDirty &= (uint8_t)~RU_CFG_DIRTY_TX;
+		// GFSK bere vykon z TX konfigurace
+		ctx->rfConfig.appliedValid &= (uint8_t)~RU_APPLIED_GFSK;
+	}
+
+	if ((which & RU_CFG_DIRTY_RX) && (ctx->rfConfig.cfgDirty & RU_CFG_DIRTY_RX))
+	{
+		uint8_t sniff;
+
+		ru_load_radio_config_rx(&ctx->rfConfig.loraParam_rx);
+		ctx->rfConfig.cfgDirty &= (uint8_t)~RU_CFG_DIRTY_RX;
+
+		// Sniff okna zavisi na preambuli a case symbolu RX konfigurace
+		NVMA_Get_LR_RX_Sniff(&sniff);
+		ctx->rfConfig.rxSniff = false;
+		if ((sniff == 1) && (ctx->rfConfig.modem == RF_MODEM_LORA))
+		{
+			if (ru_calculate_sniff_timing(&ctx->rfConfig.loraParam_rx, &ctx->rfConfig.sniffRxMs, &ctx->rfConfig.sniffSleepMs))
+			{
+				ctx->rfConfig.rxSniff = true;
+			}
+			else
+			{
+				LOG_ERROR("RX sniff: preamble too short, continuous RX used");
+			}
+		}
+	}
+}
+
+/**
+ * @brief 
+ * 
+ * @param a 
+ * @param b 
+ * @return true if packet params are the same
+ */
+static bool ru_lora_pkt_params_equal(const ral_lora_pkt_params_t *a, const ral_lora_pkt_params_t *b)
+{
+	return (a->preamble_len_in_symb == b->preamble_len_in_symb) &&
+	       (a->header_type == b->header_type) &&
+	       (a->pld_len_in_bytes == b->pld_len_in_bytes) &&
+	       (a->crc_is_on == b->crc_is_on) &&
+	       (a->invert_iq_is_on == b->invert_iq_is_on);
+}
+
+/**
+ * @brief Delta version of ralf_setup_lora() - sends to SX126x only parameters
+ *        that differ from what is already set. Back-to-back TX with the same
+ *        config costs just the packet params (payload length).
+ * 
+ * @param ctx 
+ * @param params 
+ * @param forTx PA / power is configured only before TX
+ * @return ral_status_t 
+ */
+static ral_status_t ru_radio_apply_lora(radio_context_t *ctx, const ralf_params_lora_t *params, bool forTx)
+{
+	ral_t *ral = &ctx->rfConfig.ralf.ral;
+	ralf_params_lora_t *applied = &ctx->rfConfig.loraApplied;
+	uint8_t valid = ctx->rfConfig.appliedValid;
+	ral_status_t ret = RAL_STATUS_OK;
+
+	if (valid & RU_APPLIED_GFSK)
+	{
+		// SX126x je v GFSK - LoRa se nastavi cela znovu
+		valid = 0;
+	}
+
+	// Vsechny zmenene parametry pod jednim SPI zamkem, BUSY jen pred kazdym prikazem
+	sx126x_hal_batch_begin(&ctx->rfConfig.radioHal);
+
+	if (!(valid & RU_APPLIED_SYMB_TIMEOUT) || (applied->symb_nb_timeout != params->symb_nb_timeout))
+	{
+		ret += ral_stop_timer_on_preamble(ral, false);
+		ret += ral_set_lora_symb_nb_timeout(ral, params->symb_nb_timeout);
+		applied->symb_nb_timeout = params->symb_nb_timeout;
+		valid |= RU_APPLIED_SYMB_TIMEOUT;
+	}
+
+	if (!(valid & RU_APPLIED_PKT_TYPE))
+	{
+		ret += ral_set_pkt_type(ral, RAL_PKT_TYPE_LORA);
+		valid |= RU_APPLIED_PKT_TYPE;
+	}
 
+	if (!(valid & RU_APPLIED_FREQ) || (applied->rf_freq_in_hz != params->rf_freq_in_hz))
+	{
+		ret += ral_set_rf_freq(ral, params->rf_freq_in_hz);
+		applied->rf_freq_in_hz = params->rf_freq_in_hz;
+		valid |= RU_APPLIED_FREQ;
+		// PA konfigurace zavisi i na frekvenci
+		valid &= (uint8_t)~RU_APPLIED_TX_CFG;
+	}
 
-ral_lora_cr_t get_lora_cr_from_user_value(uint8_t user_value)
-{
-	switch (user_value)
+	if (forTx && (!(valid & RU_APPLIED_TX_CFG) || (applied->output_pwr_in_dbm != params->output_pwr_in_dbm)))
 	{
-		case 45:
-			return RAL_LORA_CR_4_5;
-		case 46:
-			return RAL_LORA_CR_4_6;
-		case 47:
-			return RAL_LORA_CR_4_7;
-		case 48:
-			return RAL_LORA_CR_4_8;
-		default:
-			return RAL_LORA_CR_4_5; // Default to 4/5 if invalid value
+		ret += ral_set_tx_cfg(ral, params->output_pwr_in_dbm, params->rf_freq_in_hz);
+		applied->output_pwr_in_dbm = params->output_pwr_in_dbm;
+		valid |= RU_APPLIED_TX_CFG;
+	}
+
+	if (!(valid & RU_APPLIED_MOD) ||
+	    (applied->mod_params.sf != params->mod_params.sf) ||
+	    (applied->mod_params.bw != params->mod_params.bw) ||
+	    (applied->mod_params.cr != params->mod_params.cr) ||
+	    (applied->mod_params.ldro != params->mod_params.ldro))
+	{
+		ret += ral_set_lora_mod_params(ral, &params->mod_params);
+		applied->mod_params = params->mod_params;
+		valid |= RU_APPLIED_MOD;
+	}
+
+	if (!(valid & RU_APPLIED_PKT) || !ru_lora_pkt_params_equal(&applied->pkt_params, &params->pkt_params))
+	{
+		ret += ral_set_lora_pkt_params(ral, &params->pkt_params);
+		applied->pkt_params = params->pkt_params;
+		valid |= RU_APPLIED_PKT;
+	}
+
+	if (!(valid & RU_APPLIED_SYNC) || (applied->sync_word != params->sync_word))
+	{
+		ret += ral_set_lora_sync_word(ral, params->sync_word);
+		applied->sync_word = params->sync_word;
+		valid |= RU_APPLIED_SYNC;
+	}
+
+	if (sx126x_hal_batch_end(&ctx->rfConfig.radioHal) != SX126X_HAL_STATUS_OK)
+	{
+		ret = RAL_STATUS_ERROR;
 	}
-}
 
+	// Pri chybe radeji vse poslat znovu
+	ctx->rfConfig.appliedValid = (ret == RAL_STATUS_OK) ? valid : 0;
+
+	return ret;
+}
 
 /**
- * @brief 
+ * @brief Apply GFSK config - full ralf_setup_gfsk only after LoRa / LR-FHSS, TX power or
+ *        modem change or on a different frequency, otherwise just the payload length.
  * 
  * @param ctx 
+ * @param freq TX or RX frequency
+ * @param pldLen TX payload length, max. length for RX
+ * @return ral_status_t 
  */
-void ru_sx1262_assign( radio_context_t	*ctx)
+static ral_status_t ru_radio_apply_gfsk(radio_context_t *ctx, uint32_t freq, uint8_t pldLen)
 {
-	ctx->rfConfig.radioHal.TCXO_is_used = RF_USE_TCXO;
-
-	ctx->rfConfig.radioHal.AtomicActionEnter=vPortEnterCritical;
-	ctx->rfConfig.radioHal.AtomicActionExit=vPortExitCritical;
-	ctx->rfConfig.radioHal.pin_BUSY.port=SX1262_BUSY_GPIO_Port;
-	ctx->rfConfig.radioHal.pin_BUSY.pin=SX1262_BUSY_Pin;
-	ctx->rfConfig.radioHal.pin_RESET.port=SX1262_RESET_GPIO_Port;
-	ctx->rfConfig.radioHal.pin_RESET.pin=SX1262_RESET_Pin;
-	ctx->rfConfig.radioHal.pin_DIO1.port=SX1262_DIO1_GPIO_Port;
-	ctx->rfConfig.radioHal.pin_DIO1.pin=SX1262_DIO1_Pin;
-	ctx->rfConfig.radioHal.pin_NSS.port=SX1262_NSS_GPIO_Port;
-	ctx->rfConfig.radioHal.pin_NSS.pin=SX1262_NSS_Pin;
-	ctx->rfConfig.radioHal.pin_RF_SWITCH_1.port=SX1262_RF_SW_GPIO_Port;
-	ctx->rfConfig.radioHal.pin_RF_SWITCH_1.pin=SX1262_RF_SW_Pin;
-	ctx->rfConfig.radioHal.pin_RF_SWITCH_2.port=0;
-	ctx->rfConfig.radioHal.pin_RF_SWITCH_2.pin=0;
-	ctx->rfConfig.radioHal.TCXO_is_used=RF_USE_TCXO;
-	ctx->rfConfig.radioHal.DIO2_AS_RF_SWITCH=true;
-	ctx->rfConfig.radioHal.target=&hspi1;
-	//ctx->rfConfig.radioHal.AtomicActionEnter=vTaskSuspendAll;
-	//ctx->rfConfig.radioHal.AtomicActionExit=xTaskResumeAll;
-
-	/* config rx */
-	ctx->rfConfig.loraParam_rx.mod_params.bw=RF_RX_BW;
-	ctx->rfConfig.loraParam_rx.mod_params.cr=RF_RX_CODERATE;
-	ctx->rfConfig.loraParam_rx.mod_params.ldro=0;
-	ctx->rfConfig.loraParam_rx.mod_params.sf=RF_RX_SF;
-	ctx->rfConfig.loraParam_rx.output_pwr_in_dbm = 0;
-	ctx->rfConfig.loraParam_rx.rf_freq_in_hz=RF_RX_FREQUENCY;
-	ctx->rfConfig.loraParam_rx.pkt_params.crc_is_on=RF_RX_CRC_ON;
-	ctx->rfConfig.loraParam_rx.pkt_params.header_type=RAL_LORA_PKT_EXPLICIT;
-	ctx->rfConfig.loraParam_rx.pkt_params.invert_iq_is_on=RF_RX_IQ_INVERT;
-	ctx->rfConfig.loraParam_rx.pkt_params.preamble_len_in_symb=8;
-	ctx->rfConfig.loraParam_rx.pkt_params.pld_len_in_bytes = RF_RX_PACKET_LEN;
-	ctx->rfConfig.loraParam_rx.sync_word = 0x12;	
-
-	/* config tx */
-	ctx->rfConfig.loraParam_tx.mod_params.bw=RF_TX_BW;
-	ctx->rfConfig.loraParam_tx.mod_params.cr=RF_TX_CODERATE;
-	ctx->rfConfig.loraParam_tx.mod_params.ldro=0;
-	ctx->rfConfig.loraParam_tx.mod_params.sf=RF_TX_SF;
-	ctx->rfConfig.loraParam_tx.output_pwr_in_dbm = RF_TX_POWER;
-	ctx->rfConfig.loraParam_tx.rf_freq_in_hz=RF_TX_FREQUENCY;
-	ctx->rfConfig.loraParam_tx.pkt_params.crc_is_on=RF_TX_CRC_ON;
-	ctx->rfConfig.loraParam_tx.pkt_params.header_type=RAL_LORA_PKT_EXPLICIT;
-	ctx->rfConfig.loraParam_tx.pkt_params.invert_iq_is_on=RF_TX_IQ_INVERT;
-	ctx->rfConfig.loraParam_tx.pkt_params.preamble_len_in_symb=8;
-	ctx->rfConfig.loraParam_tx.pkt_params.pld_len_in_bytes = 1;
-	ctx->rfConfig.loraParam_tx.sync_word = 0x12;	
+	ralf_params_gfsk_t *gfsk = &ctx->rfConfig.gfskParam;
+	ral_status_t ret;
 
+	gfsk->pkt_params.pld_len_in_bytes = pldLen;
 
-	ctx->rfConfig.ralf = ( ralf_t ) RALF_SX126X_INSTANTIATE( &ctx->rfConfig.radioHal );
+	if (!(ctx->rfConfig.appliedValid & RU_APPLIED_GFSK) || (ctx->rfConfig.gfskAppliedFreq != freq))
+	{
+		gfsk->rf_freq_in_hz = freq;
+		gfsk->output_pwr_in_dbm = ctx->rfConfig.loraParam_tx.output_pwr_in_dbm;
+		sx126x_hal_batch_begin(&ctx->rfConfig.radioHal);
+		ret = ralf_setup_gfsk(&ctx->rfConfig.ralf, gfsk);
+		if (sx126x_hal_batch_end(&ctx->rfConfig.radioHal) != SX126X_HAL_STATUS_OK)
+		{
+			ret = RAL_STATUS_ERROR;
+		}
+
+		ctx->rfConfig.gfskAppliedFreq = freq;
+		ctx->rfConfig.appliedValid = (ret == RAL_STATUS_OK) ? RU_APPLIED_GFSK : 0;
+		return ret;
+	}
 
-	//Dorji module must have SW pin always high - we do it in init
-	if(ctx->rfConfig.radioHal.pin_RF_SWITCH_1.port != NULL)		HAL_GPIO_WritePin(ctx->rfConfig.radioHal.pin_RF_SWITCH_1.port, ctx->rfConfig.radioHal.pin_RF_SWITCH_1.pin, GPIO_PIN_SET);
+	ret = ral_set_gfsk_pkt_params(&ctx->rfConfig.ralf.ral, &gfsk->pkt_params);
+	if (ret != RAL_STATUS_OK)
+	{
+		ctx->rfConfig.appliedValid = 0;
+	}
 
+	return ret;
 }
 
 /**
@@ -153,14 +994,19 @@ bool ru_radioInit(radio_context_t *ctx)
 {
 	ral_status_t ret=RAL_STATUS_OK;
 	ral_t* ral;
-	ralf_t* ralf;
 	ral = &ctx->rfConfig.ralf.ral;
-	ralf = &ctx->rfConfig.ralf;	
+
+	// Po resetu cip nema nic nastaveno - cache se plni znovu
+	memset(&ctx->rfConfig.loraParam_rx, 0, sizeof(ctx->rfConfig.loraParam_rx));
+	memset(&ctx->rfConfig.loraParam_tx, 0, sizeof(ctx->rfConfig.loraParam_tx));
+	ctx->rfConfig.appliedValid = 0;
+	ctx->rfConfig.cfgDirty = RU_CFG_DIRTY_ALL;
 
 	ret+=ral_reset(ral);
 	ret+=ral_wakeup(ral);
 	ret+=ral_init(ral);
-	ret+=ralf_setup_lora(ralf, &ctx->rfConfig.loraParam_rx);
+	ru_radio_load_cached(ctx, RU_CFG_DIRTY_RX);
+	ret+=ru_radio_apply_lora(ctx, &ctx->rfConfig.loraParam_rx, false);
 	ret+=ral_set_standby(ral, RAL_STANDBY_CFG_RC);
 
 	ret+=ral_set_dio_irq_params(ral, RAL_IRQ_ALL); //RAL_IRQ_TX_DONE | RAL_IRQ_RX_DONE | RAL_IRQ_RX_CRC_ERROR);
@@ -200,6 +1046,53 @@ bool ru_radioInit(radio_context_t *ctx)
 
 }
 
+/**
+ * @brief Reset and re-init SX126x after BUSY timeout, SPI error or failed RX/CAD start - RF task context
+ * 
+ * @param ctx 
+ * @param startRx true = RF task is ON, continue RX; false = put radio to sleep
+ * @return true 
+ * @return false radio does not respond even after reset
+ */
+bool ru_radio_recover(radio_context_t *ctx, bool startRx)
+{
+	bool rxToUart = ctx->rx_to_uart;
+
+	ru_recoveries++;
+	LOG_ERROR("SX126x fault (BUSY timeout / SPI / start error), radio reset #%lu", ru_recoveries);
+
+	// Rozpracovane TX konci jako neodeslane (TX_DONE fail)
+	ru_tx_fifo_flush(ctx);
+	(void)sx126x_hal_take_fault();		// flush mohl na BUSY narazit znovu
+
+	if (ru_radioInit(ctx) == false)
+	{
+		return false;
+	}
+	ctx->rx_to_uart = rxToUart;
+
+	if (startRx)
+	{
+		ru_radio_start_rx(ctx);
+	}
+	else
+	{
+		ru_radioCleanAndSleep(false, ctx);
+	}
+
+	return sx126x_hal_take_fault() == false;
+}
+
+/**
+ * @brief 
+ * 
+ * @return uint32_t 
+ */
+uint32_t ru_get_recoveries(void)
+{
+	return ru_recoveries;
+}
+
 
 
 /**
@@ -254,6 +1147,19 @@ bool ru_load_radio_config_tx(ralf_params_lora_t *loraParam)
 uint32_t ru_calculate_toa_ms(uint8_t packetSize)
 {
 	ralf_params_lora_t loraParam;
+	uint8_t modem;
+
+	NVMA_Get_RF_Modem(&modem);
+	if (modem == RF_MODEM_GFSK)
+	{
+		ralf_params_gfsk_t gfskParam;
+		uint8_t sync[NVMA_GFSK_MAX_SYNC_LEN];
+
+		ru_load_radio_config_gfsk(&gfskParam, sync);
+		gfskParam.pkt_params.pld_len_in_bytes = packetSize;
+		return ral_sx126x_get_gfsk_time_on_air_in_ms(&gfskParam.pkt_params, &gfskParam.mod_params);
+	}
+
 	memset(&loraParam, 0, sizeof(loraParam));
 	
 	loraParam.pkt_params.pld_len_in_bytes = packetSize;
@@ -313,6 +1219,92 @@ uint32_t ru_calculate_symbol_time_us(void)
 	return sx126x_get_lora_symbol_time_us( sx126x_bw, loraParam.mod_params.sf );
 }
 
+/**
+ * @brief Load GFSK parameters from NVM (frequency, power and payload length are set on apply)
+ * 
+ * @param gfskParam 
+ * @param syncWord buffer of NVMA_GFSK_MAX_SYNC_LEN bytes, referenced by gfskParam
+ * @return true 
+ * @return false 
+ */
+bool ru_load_radio_config_gfsk(ralf_params_gfsk_t *gfskParam, uint8_t *syncWord)
+{
+	uint16_t preamble;
+	uint8_t crc;
+	uint8_t whitening;
+	uint8_t syncLen;
+
+	NVMA_Get_GFSK_Bitrate(&gfskParam->mod_params.br_in_bps);
+	NVMA_Get_GFSK_Fdev(&gfskParam->mod_params.fdev_in_hz);
+	NVMA_Get_GFSK_BW(&gfskParam->mod_params.bw_dsb_in_hz);
+	NVMA_Get_GFSK_Preamble(&preamble);
+	NVMA_Get_GFSK_CRC(&crc);
+	NVMA_Get_GFSK_Whitening(&whitening);
+	NVMA_Get_GFSK_SyncWord(syncWord, &syncLen);
+
+	gfskParam->mod_params.pulse_shape = RAL_GFSK_PULSE_SHAPE_BT_05;
+
+	gfskParam->pkt_params.preamble_len_in_bits = preamble;
+	// Detektor musi byt kratsi nez preambule
+	gfskParam->pkt_params.preamble_detector = (preamble >= 32) ? RAL_GFSK_PREAMBLE_DETECTOR_MIN_16BITS : RAL_GFSK_PREAMBLE_DETECTOR_MIN_8BITS;
+	gfskParam->pkt_params.sync_word_len_in_bits = (uint8_t)(syncLen * 8);
+	gfskParam->pkt_params.address_filtering = RAL_GFSK_ADDRESS_FILTERING_DISABLE;
+	gfskParam->pkt_params.header_type = RAL_GFSK_PKT_VAR_LEN;
+	gfskParam->pkt_params.pld_len_in_bytes = MAX_SIZE_RADIO_BUFFER;
+	gfskParam->pkt_params.crc_type = (ral_gfsk_crc_type_t)crc;
+	gfskParam->pkt_params.dc_free = whitening ? RAL_GFSK_DC_FREE_WHITENING : RAL_GFSK_DC_FREE_OFF;
+
+	gfskParam->sync_word = syncWord;
+	if ((gfskParam->pkt_params.crc_type == RAL_GFSK_CRC_1_BYTE) || (gfskParam->pkt_params.crc_type == RAL_GFSK_CRC_1_BYTE_INV))
+	{
+		gfskParam->crc_seed = 0x00FF;
+		gfskParam->crc_polynomial = 0x0007;
+	}
+	else
+	{
+		// CRC-16 CCITT
+		gfskParam->crc_seed = 0x1D0F;
+		gfskParam->crc_polynomial = 0x1021;
+	}
+	gfskParam->whitening_seed = 0x01FF;
+	gfskParam->dc_free_is_on = (whitening != 0);
+
+	return true;
+}
+
+/**
+ * @brief RX/sleep windows for RX duty-cycle from RX preamble length and symbol time
+ * 
+ * Preambule vysilace zacne tesne po konci RX okna - dalsi okno (po sleep a probuzeni)
+ * musi byt cele v preambuli: sleep + wakeup + rx <= (preambule - rezerva) * Tsym
+ * 
+ * @param loraParam RX parameters
+ * @param rxMs 
+ * @param sleepMs 
+ * @return true 
+ * @return false preamble too short for sniff
+ */
+bool ru_calculate_sniff_timing(const ralf_params_lora_t *loraParam, uint32_t *rxMs, uint32_t *sleepMs)
+{
+	uint32_t tsymUs;
+	uint32_t preambleUs;
+	uint32_t usedUs;
+
+	tsymUs = sx126x_get_lora_symbol_time_us(ru_convert_ral_to_sx126x_bw(loraParam->mod_params.bw), loraParam->mod_params.sf);
+	preambleUs = (uint32_t)loraParam->pkt_params.preamble_len_in_symb * tsymUs;
+
+	*rxMs = ((RU_SNIFF_RX_SYMB * tsymUs) + 999u) / 1000u;
+	usedUs = (*rxMs * 1000u) + (RU_SNIFF_MARGIN_SYMB * tsymUs) + RU_SNIFF_WAKEUP_US;
+
+	if (preambleUs < (usedUs + 1000u))
+	{
+		return false;
+	}
+
+	*sleepMs = (preambleUs - usedUs) / 1000u;
+	return true;
+}
+
 bool ru_load_radio_config_rx(ralf_params_lora_t *loraParam)
 {	
 	uint8_t bw;
@@ -403,6 +1395,8 @@ bool ru_radioCleanAndSleep( bool onlySleep, radio_context_t *ctx)
 
 	ral_clear_irq_status(ral, RAL_IRQ_ALL);
 	ral_set_sleep(ral, RAL_STANDBY_CFG_RC);
+	// V cold sleep SX126x konfiguraci ztraci
+	ctx->rfConfig.appliedValid = 0;
 
 	return true;
 }
@@ -420,17 +1414,46 @@ bool ru_radioCleanAndSleep( bool onlySleep, radio_context_t *ctx)
 bool ru_radio_send_packet(uint8_t *data, uint8_t size, radio_context_t	*ctx)
 {
 	ral_t* ral;
-	ralf_t* ralf;
 
-	ralf = &ctx->rfConfig.ralf;	
 	ral = &ctx->rfConfig.ralf.ral;
 
 	ral_set_dio_irq_params(ral, RAL_IRQ_TX_DONE );
+	ru_radio_prepare_tx(data, size, ctx);
+
+	ru_radio_rfSwitch(true,ctx);
+	ral_set_tx(ral);
+
+	ctx->rfConfig.lastMode = RF_MODE_TX;
+
+	return true;
+}
+
+/**
+ * @brief Load TX parameters and payload into SX126x without starting TX
+ * 
+ * @param data 
+ * @param size 
+ * @param ctx 
+ */
+static void ru_radio_prepare_tx(uint8_t *data, uint8_t size, radio_context_t *ctx)
+{
+	ral_t* ral;
+
+	ral = &ctx->rfConfig.ralf.ral;
+
+	ru_radio_load_cached(ctx, RU_CFG_DIRTY_TX);
+
+	if (ctx->rfConfig.modem == RF_MODEM_GFSK)
+	{
+		ru_radio_apply_gfsk(ctx, ctx->rfConfig.loraParam_tx.rf_freq_in_hz, size);
+		LOG_INFO("TX params: GFSK Freq: %lu Hz, BR: %lu bps", ctx->rfConfig.loraParam_tx.rf_freq_in_hz, ctx->rfConfig.gfskParam.mod_params.br_in_bps);
+		ral_set_pkt_payload(ral, data, size);
+		return;
+	}
 
 	ctx->rfConfig.loraParam_tx.pkt_params.pld_len_in_bytes = size;
-	ru_load_radio_config_tx(&ctx->rfConfig.loraParam_tx);
 
-	ralf_setup_lora(ralf, &ctx->rfConfig.loraParam_tx);
+	ru_radio_apply_lora(ctx, &ctx->rfConfig.loraParam_tx, true);
 
 	LOG_INFO("TX params: Freq: %lu Hz, SF: %d, BW: %d, CR: %d/%d, Preamble: %d symb, CRC: %s, IQ Inv: %s",
 		ctx->rfConfig.loraParam_tx.rf_freq_in_hz,
@@ -444,12 +1467,6 @@ bool ru_radio_send_packet(uint8_t *data, uint8_t size, radio_context_t	*ctx)
 	);
 
 	ral_set_pkt_payload(ral, data, size);
-	ru_radio_rfSwitch(true,ctx);
-	ral_set_tx(ral);
-
-	ctx->rfConfig.lastMode = RF_MODE_TX;
-
-	return true;
 }
 
 /**
@@ -487,35 +1504,68 @@ void ru_radio_rfSwitch(bool tx,radio_context_t	*ctx)
 void ru_radio_start_rx(radio_context_t	*ctx)
 {
 	ral_t* ral;
-	ralf_t* ralf;
 	ral_status_t ret=RAL_STATUS_OK;
+	uint32_t t0;
 	ral = &ctx->rfConfig.ralf.ral;
-	ralf = &ctx->rfConfig.ralf;
 
+	// Radio je od standby do set_rx hluche
+	t0 = TIM_GetTimestampUs();
 	ru_radioCleanAndStandby(RAL_STANDBY_CFG_XOSC, ctx);
 
-	ru_load_radio_config_rx(&ctx->rfConfig.loraParam_rx);
-
-	// log all rx params
-	LOG_INFO("RX params: Freq: %lu Hz, SF: %d, BW: %d, CR: %d/%d, Preamble: %d symb, CRC: %s, IQ Inv: %s",
-		ctx->rfConfig.loraParam_rx.rf_freq_in_hz,
-		ctx->rfConfig.loraParam_rx.mod_params.sf,
-		ctx->rfConfig.loraParam_rx.mod_params.bw,
-		(ctx->rfConfig.loraParam_rx.mod_params.cr + 4),
-		4,
-		ctx->rfConfig.loraParam_rx.pkt_params.preamble_len_in_symb,
-		ctx->rfConfig.loraParam_rx.pkt_params.crc_is_on ? "ON" : "OFF",
-		ctx->rfConfig.loraParam_rx.pkt_params.invert_iq_is_on ? "ON" : "OFF"
-	);
+	ru_radio_load_cached(ctx, RU_CFG_DIRTY_RX);
 
-	ret += ralf_setup_lora(ralf, &ctx->rfConfig.loraParam_rx);
+	// Konfigurace az po set_rx jako jedna davka
+	sx126x_hal_batch_begin(&ctx->rfConfig.radioHal);
+	if (ctx->rfConfig.modem == RF_MODEM_GFSK)
+	{
+		// Promenna delka paketu - max. delka pro prijem
+		LOG_INFO("RX params: GFSK Freq: %lu Hz, BR: %lu bps", ctx->rfConfig.loraParam_rx.rf_freq_in_hz, ctx->rfConfig.gfskParam.mod_params.br_in_bps);
+		ret += ru_radio_apply_gfsk(ctx, ctx->rfConfig.loraParam_rx.rf_freq_in_hz, MAX_SIZE_RADIO_BUFFER);
+	}
+	else
+	{
+		// log all rx params
+		LOG_INFO("RX params: Freq: %lu Hz, SF: %d, BW: %d, CR: %d/%d, Preamble: %d symb, CRC: %s, IQ Inv: %s",
+			ctx->rfConfig.loraParam_rx.rf_freq_in_hz,
+			ctx->rfConfig.loraParam_rx.mod_params.sf,
+			ctx->rfConfig.loraParam_rx.mod_params.bw,
+			(ctx->rfConfig.loraParam_rx.mod_params.cr + 4),
+			4,
+			ctx->rfConfig.loraParam_rx.pkt_params.preamble_len_in_symb,
+			ctx->rfConfig.loraParam_rx.pkt_params.crc_is_on ? "ON" : "OFF",
+			ctx->rfConfig.loraParam_rx.pkt_params.invert_iq_is_on ? "ON" : "OFF"
+		);
+
+		ret += ru_radio_apply_lora(ctx, &ctx->rfConfig.loraParam_rx, false);
+	}
 	ret += ral_set_dio_irq_params(ral, RAL_IRQ_RX_DONE | RAL_IRQ_RX_TIMEOUT | RAL_IRQ_RX_CRC_ERROR);
 	ret += ral_cfg_rx_boosted(ral, true);
-	ret += ral_set_rx(ral, RAL_RX_TIMEOUT_CONTINUOUS_MODE);
+	if (ctx->rfConfig.rxSniff)
+	{
+		// Sniff - SX126x strida RX okno a sleep, pri detekci preambule zustane v RX
+		ret += ral_set_rx_duty_cycle(ral, ctx->rfConfig.sniffRxMs, ctx->rfConfig.sniffSleepMs);
+	}
+	else
+	{
+		ret += ral_set_rx(ral, RAL_RX_TIMEOUT_CONTINUOUS_MODE);
+	}
+	if (sx126x_hal_batch_end(&ctx->rfConfig.radioHal) != SX126X_HAL_STATUS_OK)
+	{
+		ret = RAL_STATUS_ERROR;
+	}
 
-	if(ret != RAL_STATUS_OK) _exit(5315321);
+	if(ret != RAL_STATUS_OK)
+	{
+		// Radio se po navratu z handleru resetuje v RF tasku (ru_radio_recover)
+		LOG_ERROR("RX start failed");
+		sx126x_hal_set_fault();
+		ctx->rfConfig.lastMode = RF_MODE_IDLE;
+		return;
+	}
 
 	ctx->rfConfig.lastMode = RF_MODE_RX;
+	ru_rxStats.fullRearms++;
+	ru_rx_stats_gap(TIM_GetTimestampUs() - t0);
 }
 
 
@@ -527,15 +1577,14 @@ void ru_radio_start_rx(radio_context_t	*ctx)
 void ru_radio_start_CAD(radio_context_t	*ctx)
 {
 	ral_t* ral;
-	ralf_t* ralf;
 	ral_lora_cad_params_t cadPar;
 
 	ral_status_t ret=RAL_STATUS_OK;
 	ral = &ctx->rfConfig.ralf.ral;
-	ralf = &ctx->rfConfig.ralf;
 	ru_radioCleanAndStandby(RAL_STANDBY_CFG_RC, ctx);
 
-	ret += ralf_setup_lora(ralf, &ctx->rfConfig.loraParam_rx);
+	ru_radio_load_cached(ctx, RU_CFG_DIRTY_RX);
+	ret += ru_radio_apply_lora(ctx, &ctx->rfConfig.loraParam_rx, false);
 	ret += ral_set_dio_irq_params(ral, RAL_IRQ_ALL);
 
 	cadPar.cad_det_min_in_symb = 10;
@@ -547,7 +1596,13 @@ void ru_radio_start_CAD(radio_context_t	*ctx)
 	ret += ral_set_lora_cad_params(ral, &cadPar);
 	ret += ral_set_lora_cad(ral);
 
-	if(ret != RAL_STATUS_OK) _exit(68431);
+	if(ret != RAL_STATUS_OK)
+	{
+		LOG_ERROR("CAD start failed");
+		sx126x_hal_set_fault();
+		ctx->rfConfig.lastMode = RF_MODE_IDLE;
+		return;
+	}
 
 	ctx->rfConfig.lastMode = RF_MODE_CAD;
 
@@ -574,9 +1629,7 @@ radio_modes_e	ru_get_radio_last_status( radio_context_t	*ctx)
 void ru_radio_process_commands(RFCommands_e cmd,radio_context_t *ctx, const dataQueue_t *rxm)
 {
 	ral_t* ral;
-	ralf_t* ralf;
 	ral = &ctx->rfConfig.ralf.ral;
-	ralf = &ctx->rfConfig.ralf;
 	packet_info_t *pkt;
 
 	switch (cmd)
@@ -598,9 +1651,8 @@ void ru_radio_process_commands(RFCommands_e cmd,radio_context_t *ctx, const data
 
 		case RADIO_CMD_TX_CW:
 			ru_radioCleanAndStandby(RAL_STANDBY_CFG_XOSC,ctx);
-			ru_load_radio_config_tx(&ctx->rfConfig.loraParam_tx);
-
-			ralf_setup_lora(ralf, &ctx->rfConfig.loraParam_tx);
+			ru_radio_load_cached(ctx, RU_CFG_DIRTY_TX);
+			ru_radio_apply_lora(ctx, &ctx->rfConfig.loraParam_tx, true);
 
 			// Now enable TX CW mode
 			ru_radio_rfSwitch(true, ctx);
@@ -621,13 +1673,12 @@ void ru_radio_process_commands(RFCommands_e cmd,radio_context_t *ctx, const data
 			HW_LED_RF_EVENT_ON();
 			osTimerStart(ctx->timers.rfEventLedTimer.timer,pdMS_TO_TICKS(RF_EVENT_LED_TIMEOUT_MS));
 
-			vPortFree(pkt->packet);
 			LOG_INFO("RF data sent: %d B, TOA: %lu ms", pkt->size, ru_calculate_toa_ms(pkt->size));
 
 			break;
 
 		case RADIO_CMD_SEND_UNIVERSAL_PAYLOAD_LBT:
-
+			// Pakety s LBT jdou pres TX FIFO (CMD_RF_SEND_DATA_LBT)
 			break;
 
 		case RADIO_CMD_START_RX:
@@ -651,18 +1702,21 @@ void ru_radio_process_commands(RFCommands_e cmd,radio_context_t *ctx, const data
  * @brief 
  * 
  * @param ctx 
+ * @param irqTimeUs cas DIO1 IRQ zachyceny v EXTI
  */
-void ru_radio_process_IRQ(radio_context_t *ctx)
+void ru_radio_process_IRQ(radio_context_t *ctx, uint32_t irqTimeUs)
 {
 	radio_modes_e	mode;
 	ral_t* 			ral = &ctx->rfConfig.ralf.ral;
-	uint8_t			rxPayload[MAX_SIZE_RADIO_BUFFER];
-	uint16_t		rxSize;
+	uint16_t		rxSize = 0;
+	bool			rxOk;
 	ral_irq_t		irqSet;
-	int16_t			RSSI;
+	ral_lora_rx_pkt_status_t pktStatus;
+	ral_gfsk_rx_pkt_status_t gfskStatus;
+	ral_lora_cr_t	rxCr;
+	bool			rxCrc;
 	dataQueue_t		txm;	//tx message
 	packet_info_t	*rx_pkt;
-	uint8_t			*rx_raw_data;
 
 	mode = ru_get_radio_last_status(ctx);
 	ral_get_irq_status(ral, &irqSet);
@@ -673,56 +1727,162 @@ void ru_radio_process_IRQ(radio_context_t *ctx)
 	
 		    if (((irqSet & RAL_IRQ_RX_DONE) == RAL_IRQ_RX_DONE) && ((irqSet & RAL_IRQ_RX_CRC_ERROR) != RAL_IRQ_RX_CRC_ERROR))
 		    {
-		    	if(ral_get_pkt_payload(ral,MAX_SIZE_RADIO_BUFFER,rxPayload,&rxSize) == RAL_STATUS_OK)
-		    	{
-					ral_get_rssi_inst(ral, &RSSI);	
-					LOG_INFO("RX: %d B, RSSI: %d dBm", rxSize, (int16_t)RSSI);
+				ru_rxStats.packets++;
+				rx_pkt = NULL;
+				if (ctx->rx_to_uart == true)
+				{
+					rx_pkt = pkt_pool_alloc(PKT_POOL_RX);
+					if (rx_pkt == NULL)
+					{
+						// Vsechny RX sloty cekaji na UART - paket se zahodi (AT+RF_POOL_STAT)
+						LOG_WARNING("RX pool full, packet dropped");
+					}
+				}
+
+				if (rx_pkt != NULL)
+				{
+					// Payload se cte z SX126x rovnou do slotu poolu - bez mezibufferu na stacku
+					rxOk = (ral_get_pkt_payload(ral, PKT_POOL_DATA_SIZE, rx_pkt->packet, &rxSize) == RAL_STATUS_OK);
+				}
+				else
+				{
+					// Bez vystupu na UART staci delka paketu pro log
+					rxOk = (ral_get_rx_pkt_len(ral, &rxSize) == RAL_STATUS_OK);
+				}
 
-					if(ctx->rx_to_uart == true && rxSize > 0)
+		    	if(rxOk)
+		    	{
+					// Metriky posledniho paketu - ne okamzite RSSI (to je uz jen sum kanalu)
+					if (ctx->rfConfig.modem == RF_MODEM_GFSK)
 					{
-						rx_raw_data =  pvPortMalloc(rxSize);
-						if (rx_raw_data == NULL)
+						// GFSK nema SNR ani CR - SRSSI = RSSI pri detekci sync wordu
+						if (ral_get_gfsk_rx_pkt_status(ral, &gfskStatus) != RAL_STATUS_OK)
 						{
-							_exit(313513);
+							memset(&gfskStatus, 0, sizeof(gfskStatus));
 						}
+						pktStatus.rssi_pkt_in_dbm = gfskStatus.rssi_avg_in_dbm;
+						pktStatus.snr_pkt_in_db = 0;
+						pktStatus.signal_rssi_pkt_in_dbm = gfskStatus.rssi_sync_in_dbm;
+						rxCr = (ral_lora_cr_t)0;
+						rxCrc = (ctx->rfConfig.gfskParam.pkt_params.crc_type != RAL_GFSK_CRC_OFF);
+					}
+					else
+					{
+						if (ral_get_lora_rx_pkt_status(ral, &pktStatus) != RAL_STATUS_OK)
+						{
+							memset(&pktStatus, 0, sizeof(pktStatus));
+						}
+						if (ral_get_lora_rx_pkt_cr_crc(ral, &rxCr, &rxCrc) != RAL_STATUS_OK)
+						{
+							rxCr = (ral_lora_cr_t)0;
+							rxCrc = false;
+						}
+					}
+					LOG_INFO("RX: %d B, RSSI: %d dBm, SNR: %d dB", rxSize, pktStatus.rssi_pkt_in_dbm, pktStatus.snr_pkt_in_db);
 
-						memcpy(rx_raw_data,&rxPayload,rxSize);
-
-						rx_pkt = pvPortMalloc(sizeof(packet_info_t));
-						rx_pkt->packet = rx_raw_data;
-						rx_pkt->size = rxSize;
-						rx_pkt->rx_rssi = RSSI;
+					if(rx_pkt != NULL && rxSize > 0)
+					{
+						rx_pkt->size = (uint8_t)rxSize;
+						rx_pkt->rx_rssi = pktStatus.rssi_pkt_in_dbm;
+						rx_pkt->rx_snr = (int8_t)pktStatus.snr_pkt_in_db;
+						rx_pkt->rx_signal_rssi = pktStatus.signal_rssi_pkt_in_dbm;
+						rx_pkt->rx_cr = (uint8_t)rxCr;
+						rx_pkt->rx_crc = rxCrc;
+						rx_pkt->rx_time_us = irqTimeUs;
 
 						txm.cmd = CMD_MAIN_RF_RX_PACKET;
 						txm.ptr = rx_pkt;
 
 						xQueueSend(queueMainHandle,&txm,portMAX_DELAY);
+						rx_pkt = NULL;
 
 						HW_LED_RF_EVENT_ON();
 						osTimerStart(ctx->timers.rfEventLedTimer.timer,pdMS_TO_TICKS(RF_EVENT_LED_TIMEOUT_MS));
 					}
-					
 		    	}
+
+				// Slot, ktery se neposlal main tasku (chyba cteni, prazdny paket)
+				pkt_pool_free(rx_pkt);
 		    }
 			else if(irqSet & RAL_IRQ_RX_CRC_ERROR)
 			{
 				LOG_DEBUG("Semtech CRC Error");
 			}
 
-		//	ru_radioCleanAndStandby(RAL_STANDBY_CFG_XOSC, ctx);
-		    ru_radio_start_rx(ctx);
+			if ((ctx->rfConfig.cfgDirty & RU_CFG_DIRTY_RX) == 0)
+			{
+				// SX126x zustava v continuous RX - jen smazat IRQ, bez standby a nove konfigurace
+				uint32_t t0 = TIM_GetTimestampUs();
+
+				ral_clear_irq_status(ral, irqSet);
+				if (ctx->rfConfig.rxSniff)
+				{
+					// Po prijmu v duty-cycle prejde SX126x do standby - jen znovu spustit cyklus
+					ral_set_rx_duty_cycle(ral, ctx->rfConfig.sniffRxMs, ctx->rfConfig.sniffSleepMs);
+					ru_rx_stats_gap(TIM_GetTimestampUs() - t0);
+				}
+				else
+				{
+					ru_rx_stats_gap(0);
+				}
+				osTimerStart(ctx->timers.rfHBTimer.timer,pdMS_TO_TICKS(RF_HEART_BEAT_TIMEOUT_MS));
+				ru_rxStats.fastRearms++;
+			}
+			else
+			{
+				// Zmena nastaveni - plna rekonfigurace
+				ru_radio_start_rx(ctx);
+			}
 
 			break;
 
 		case RF_MODE_TX:
-			ru_radio_start_rx(ctx);
+			if (ctx->txFifo.schedArmed)
+			{
+				// Zbytek RX IRQ z doby pred preloadem - SetTx jeste neodesel
+				ral_clear_irq_status(ral, irqSet);
+				break;
+			}
+			if (ctx->txFifo.lrFhss)
+			{
+				if ((irqSet & RAL_IRQ_LR_FHSS_HOP) == RAL_IRQ_LR_FHSS_HOP)
+				{
+					// Doplnit dalsi hop do tabulky SX126x, TX bezi dal
+					ral_lr_fhss_handle_hop(ral, &ru_lrFhssParams, &ru_lrFhssState);
+					ral_clear_irq_status(ral, RAL_IRQ_LR_FHSS_HOP);
+				}
+				if ((irqSet & RAL_IRQ_TX_DONE) != RAL_IRQ_TX_DONE)
+				{
+					break;
+				}
+				ral_lr_fhss_handle_tx_done(ral, &ru_lrFhssParams, &ru_lrFhssState);
+				ctx->txFifo.lrFhss = false;
+			}
+
+			if (ctx->txFifo.count > 0)
+			{
+				ctx->txFifo.doneUs = irqTimeUs;
+				ru_tx_fifo_pop(ctx, (irqSet & RAL_IRQ_TX_DONE) == RAL_IRQ_TX_DONE);
+			}
 
-			txm.cmd = CMD_MAIN_RF_TX_DONE;
-			txm.ptr = NULL;
-			xQueueSend(queueMainHandle,&txm,portMAX_DELAY);
+			if (ctx->txFifo.count > 0)
+			{
+				// Dalsi paket hned po TX done - bez navratu do RX
+				ral_clear_irq_status(ral, RAL_IRQ_ALL);
+				ru_tx_fifo_start_head(ctx);
+			}
+			else
+			{
+				ru_radio_start_rx(ctx);
+			}
 			break;
 
 		case RF_MODE_CAD:
+			if (ctx->txFifo.lbtCad)
+			{
+				ru_lbt_cad_done(ctx, irqSet);
+				break;
+			}
 			if(irqSet & RAL_IRQ_CAD_DONE )
 			{
 				ru_radioCleanAndStandby(RAL_STANDBY_CFG_XOSC, ctx);
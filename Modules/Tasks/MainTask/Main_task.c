@@ -9,8 +9,10 @@
 #include "main_task.h"
 #include "projdefs.h"
 #include "radio_user.h"
+#include "pkt_pool.h"
 #include "semphr.h"
 #include "AT_cmd.h"
+#include "AT_binary.h"
 #include "general_sys_cmd.h"
 #include "NVMA.h"
 #include "auxPin_logic.h"
@@ -20,10 +22,6 @@
 #include "Log.h"
 //#include "process_main_task.h"
 
-// Struktura pro uložení statického semaforu
-StaticSemaphore_t xSemaphoreBuffer_USART;
-SemaphoreHandle_t xBinarySemaphore_USART;
-
 extern UART_HandleTypeDef huart1;
 extern osMessageQId queueRadioHandle;
 extern osMessageQId queueMainHandle;
@@ -39,10 +37,10 @@ volatile uint32_t GL_debug=0;
 void (*main_task_states[2])(main_ctx_t *ctx, dataQueue_t *rxd) = {main_task_off, main_task_on};
 
 
-static uint8_t rxBuffer_USART[MAX_UART_RX_BUFFER];
-static uint8_t txBuffer_USART[MAX_UART_RX_BUFFER];
+static uint8_t rxRing_USART[SP_RX_RING_SIZE];
+static uint8_t txBuffer_USART[MAX_UART_TX_BUFFER];
 
-static uint8_t rxShadowBuffer_USART[MAX_UART_RX_BUFFER];
+static TimerHandle_t _Main_LED_AT_RX_Timer;
 
 static SemaphoreHandle_t _Main_QueueSemaphore;
 static StaticSemaphore_t _Main_QueueSemaphoreBuffer;
@@ -97,110 +95,72 @@ static void GeneralSys_IWDG_Callback(TimerHandle_t xTimer)
 }
 
 /**
- * @brief 
+ * @brief Dispatch parsed AT command to GSC - called from main task context
  * 
  * @param data 
  * @param atCmd 
  * @param size 
- * @return true 
- * @return false 
  */
-bool AT_CustomCommandHandler(char *data,eATCommands atCmd, uint16_t size)
+void AT_CustomCommandHandler(char *data,eATCommands atCmd, uint16_t size)
 {
-	dataQueue_t txm;
-	txm.ptr = NULL;
-
-	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-
-	if(xSemaphoreTakeFromISR(xBinarySemaphore_USART, &xHigherPriorityTaskWoken) == pdTRUE)
+	if (GSC_ProcessCommand(atCmd, (uint8_t *)data, size))
 	{
-		memcpy(rxShadowBuffer_USART, data, size);
-		txm.cmd = CMD_MAIN_AT_RX_PACKET;
-		txm.tmp_8 = (uint8_t) atCmd;
-		txm.tmp_16 = size;
-		MT_SendDataToMainTask(&txm);
-
-		portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+		HW_LED_AT_RX_ON();
+		osTimerStart(_Main_LED_AT_RX_Timer, pdMS_TO_TICKS(100));
 	}
-	else
-	{
-		return false;
-	}
-
-	return true;
 }
 
 
-void AT_SendRfPacketResponse(uint8_t *packet, int16_t rssi, uint16_t length)
+/**
+ * @brief Format received packet as +RX:<len>,<data>,RSSI:..,SNR:..,SRSSI:..,CR:..,CRC:..,TS:..
+ * 
+ * @param pkt 
+ */
+void AT_SendRfPacketResponse(packet_info_t *pkt)
 {
-    uint8_t response[600]={0}; 
+    static const char * const cr_names[] = {"?", "4/5", "4/6", "4/7", "4/8", "4/5LI", "4/6LI", "4/8LI"};
+    char prefix[12];
+    char metrics[80];
+    AT_TxWriter_t wr;
     uint8_t rxFormat;
+    int prefixLen;
+    int metricsLen;
+    uint16_t dataLen;
 
-    uint16_t response_size = 0;
-    int ret;
-    
     // Get configured output format
     NVMA_Get_RX_Format(&rxFormat);
 
-    // Přidání prefixu a délky
-    ret = snprintf((char *)&response[response_size], sizeof(response) - response_size, "+RX:%u,", length);
-    if (ret < 0 || ret >= (int)(sizeof(response) - response_size))
+    // Prefix a metriky jsou kratke - payload se formatuje primo do Tx ringu
+    prefixLen = snprintf(prefix, sizeof(prefix), "+RX:%u,", pkt->size);
+    metricsLen = snprintf(metrics, sizeof(metrics), ",RSSI:%d,SNR:%d,SRSSI:%d,CR:%s,CRC:%u,TS:%lu\r\n",
+                   pkt->rx_rssi, pkt->rx_snr, pkt->rx_signal_rssi,
+                   cr_names[(pkt->rx_cr < (sizeof(cr_names) / sizeof(cr_names[0]))) ? pkt->rx_cr : 0],
+                   pkt->rx_crc ? 1u : 0u, (unsigned long)pkt->rx_time_us);
+    if ((prefixLen < 0) || (prefixLen >= (int)sizeof(prefix)) || (metricsLen < 0) || (metricsLen >= (int)sizeof(metrics)))
     {
         // Chyba při formátování nebo nedostatek místa v bufferu
         return;
     }
-    response_size += ret;
 
-    if (rxFormat == RX_FORMAT_ASCII)
+    dataLen = (rxFormat == RX_FORMAT_ASCII) ? pkt->size : (uint16_t)(2 * pkt->size);
+    if (!AT_TxBegin(&wr, (uint16_t)(prefixLen + dataLen + metricsLen)))
     {
-        // ASCII format - copy printable chars, replace non-printable with '.'
-        for (uint16_t i = 0; i < length; i++)
-        {
-            if (response_size + 1 >= (uint16_t)sizeof(response))
-            {
-                return;
-            }
-            uint8_t byte = packet[i];
-            // Print printable ASCII chars (32-126), replace others with '.'
-            response[response_size++] = (byte >= 32 && byte <= 126) ? byte : '.';
-        }
-    }
-    else
-    {
-        // HEX format (default)
-        static const char hex_digits[] = "0123456789ABCDEF";
-        for (uint16_t i = 0; i < length; i++)
-        {
-            if (response_size + 2 >= (uint16_t)sizeof(response))
-            {
-                return;
-            }
-            uint8_t byte = packet[i];
-            response[response_size++] = hex_digits[(byte >> 4) & 0x0F];
-            response[response_size++] = hex_digits[byte & 0x0F];
-        }
+        return;
     }
 
-    // Přidání RSSI na konec
-    ret = snprintf((char *)&response[response_size], sizeof(response) - response_size, ",RSSI:%d", rssi);
-    if (ret < 0 || ret >= (int)(sizeof(response) - response_size))
+    AT_TxPut(&wr, (const uint8_t *)prefix, (uint16_t)prefixLen);
+    if (rxFormat == RX_FORMAT_ASCII)
     {
-        // Chyba nebo nedostatek místa v bufferu
-        return;
+        // ASCII format - non-printable chars replaced with '.'
+        AT_TxPutPrintable(&wr, pkt->packet, pkt->size);
     }
-    response_size += ret;
-
-    // Přidání odřádkování
-    if ((unsigned int)response_size + 2 >= sizeof(response))
+    else
     {
-        // Nedostatek místa v bufferu
-        return;
+        // HEX format (default)
+        AT_TxPutHex(&wr, pkt->packet, pkt->size);
     }
-    response[response_size++] = '\r';
-    response[response_size++] = '\n';
-
-    // Odeslání odpovědi
-    AT_SendStringResponse((char *)response);
+    AT_TxPut(&wr, (const uint8_t *)metrics, (uint16_t)metricsLen);
+    AT_TxEnd(&wr);
 }
 
 
@@ -229,20 +189,50 @@ void main_task_off(main_ctx_t *ctx,dataQueue_t *rxd)
 void main_task_on(main_ctx_t *ctx, dataQueue_t *rxd)
 {
 	packet_info_t	*rx_pkt;
-	bool 	AtCmdProcessed;
 
 	switch (rxd->cmd)
 	{
 		case CMD_MAIN_RF_RX_PACKET:
 			rx_pkt = rxd->ptr;
 			
-			AT_SendRfPacketResponse(rx_pkt->packet, rx_pkt->rx_rssi,rx_pkt->size);
-			vPortFree(rx_pkt->packet);
-			rx_pkt->packet=NULL;
-
+			if (AT_IsBinaryMode())
+			{
+				ATB_SendRxPacket(rx_pkt);
+			}
+			else if (AT_IsStreamMode())
+			{
+				// Transparentni rezim - jen surova data
+				AT_SendData(rx_pkt->packet, rx_pkt->size);
+			}
+			else
+			{
+				AT_SendRfPacketResponse(rx_pkt);
+			}
 			break;
 
         case CMD_MAIN_RF_TX_DONE:
+            // tmp_16 = ID paketu, tmp_32 = TOA [ms], data = cas TX done [us], tmp_bool = false -> paket zahozen
+            GSC_TxDone();
+            if (AT_IsBinaryMode())
+            {
+                ATB_SendTxDone(rxd->tmp_16, rxd->tmp_32, rxd->data, rxd->tmp_bool);
+            }
+            else if (!AT_IsStreamMode())
+            {
+                char txDone[40];
+                if (rxd->tmp_bool)
+                {
+                    snprintf(txDone, sizeof(txDone), "+TXDONE:%u,%lu,%lu\r\n", rxd->tmp_16, (unsigned long)rxd->tmp_32, (unsigned long)rxd->data);
+                }
+                else
+                {
+                    snprintf(txDone, sizeof(txDone), "+TXFAIL:%u\r\n", rxd->tmp_16);
+                }
+                AT_SendStringResponse(txDone);
+            }
+            // Stream mode posila dalsi paket az po dokonceni predchoziho
+            AT_StreamTxDone();
+
             // Kontrola zda je aktivní periodické vysílání (timer ID != NULL)
             if (pvTimerGetTimerID(ctx->timers.Periodic_RF_TX.timer) != NULL)
             {
@@ -258,15 +248,13 @@ void main_task_on(main_ctx_t *ctx, dataQueue_t *rxd)
             break;
 
 		case CMD_MAIN_AT_RX_PACKET:
-			AtCmdProcessed = GSC_ProcessCommand((eATCommands) rxd->tmp_8, rxShadowBuffer_USART, rxd->tmp_16);
-            if(AtCmdProcessed)
-            {
-                HW_LED_AT_RX_ON();
-                osTimerStart(ctx->timers.LED_AT_RX_done.timer, pdMS_TO_TICKS(100));
-            }
-            
-			xSemaphoreGive(xBinarySemaphore_USART);
+			// Rx udalost z UART ISR - radky z ringu se skladaji do FIFO prikazu
+			AT_HandleRxEvent(rxd->tmp_16, rxd->tmp_8, rxd->tmp_32);
+			break;
 
+		case CMD_MAIN_AT_UART_ERROR:
+			// tmp_bool = ISR restartoval Rx DMA
+			AT_HandleUartError(rxd->tmp_bool);
 			break;
 
 		case CMD_MAIN_IWDG_REFRESH:
@@ -377,19 +365,9 @@ void main_task(void)
     ctx.timers.LED_AT_RX_done.timer = xTimerCreateStatic("LED RX done", pdMS_TO_TICKS(100), pdFALSE, NULL, 
                                                         _Main_RX_AT_done_Callback,  &ctx.timers.LED_AT_RX_done.timerPlace);
 
-	osTimerStart(ctx.timers.LED_alive.timer, pdMS_TO_TICKS(100));
-
-	/* init and start recieve*/
-	if (xBinarySemaphore_USART == NULL)
-    {
-        // Vytvoření semaforu
-        xBinarySemaphore_USART = xSemaphoreCreateBinaryStatic(&xSemaphoreBuffer_USART);
+	_Main_LED_AT_RX_Timer = ctx.timers.LED_AT_RX_done.timer;
 
-        if (xBinarySemaphore_USART != NULL)
-        {
-            xSemaphoreGive(xBinarySemaphore_USART);
-        }
-    }
+	osTimerStart(ctx.timers.LED_alive.timer, pdMS_TO_TICKS(100));
 
 	NVMA_Init();
 	
@@ -400,13 +378,13 @@ void main_task(void)
 	}
 
 	AT_cmd_t at_ctx;
-	at_ctx.sp_ctx.rxStorage.raw_data = rxBuffer_USART;
-	at_ctx.sp_ctx.rxStorage.size = MAX_UART_RX_BUFFER;
+	at_ctx.sp_ctx.rxStorage.raw_data = rxRing_USART;
+	at_ctx.sp_ctx.rxStorage.size = SP_RX_RING_SIZE;
 	at_ctx.sp_ctx.txStorage.raw_data = txBuffer_USART;
 	at_ctx.sp_ctx.txStorage.size = MAX_UART_TX_BUFFER;
 	at_ctx.sp_ctx.phuart = &huart1;
-	// Assign the custom command handler to be called when data is received from ISR
-	at_ctx.onDataReceivedFromISR = AT_CustomCommandHandler;
+	// Assign the custom command handler - called from main task for every queued command
+	at_ctx.onDataReceived = AT_CustomCommandHandler;
     AT_Init(&at_ctx);
 
     AUX_InitTimers();
@@ -436,16 +414,20 @@ void main_task(void)
 
 	for(;;)
 	{
-		ret = xQueueReceive(queueMainHandle, &rxd, portMAX_DELAY);
+		// Pokud cekaji AT prikazy, jen se podivame do fronty - zpravy maji prednost;
+		// ve stream modu se ceka nejdele do uplynuti mezery mezi bajty
+		ret = xQueueReceive(queueMainHandle, &rxd, AT_RxWaitTicks());
 		if (ret == pdPASS)
 		{
 			main_task_states[ctx.task_state](&ctx, &rxd);
 
-			/* Clear malloc */
-			vPortFree(rxd.ptr);
+			/* Vratit paket do poolu */
+			pkt_pool_free(rxd.ptr);
 			rxd.ptr=NULL;
 		}
 
+		// Jeden AT prikaz na iteraci, mezi prikazy se vycita Rx ring
+		AT_ProcessCommandFifo();
 	}
 }
 
@@ -56,6 +56,6 @@ typedef struct
 void main_task(void);
 void irq_RELE_falling(void);
 bool MT_SendDataToMainTask(dataQueue_t *data);
-bool AT_CustomCommandHandler(char *data,eATCommands atCmd, uint16_t size);
+void AT_CustomCommandHandler(char *data,eATCommands atCmd, uint16_t size);
 
 #endif /* INC_MAIN_TASK_H_ */
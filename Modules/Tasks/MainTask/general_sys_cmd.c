@@ -18,10 +18,14 @@
 #include <stdio.h>
 #include "AT_cmd.h"
 #include "radio_user.h"
+#include "pkt_pool.h"
+#include "sx126x_hal.h"
 #include <errno.h>
 #include "auxPin_logic.h"
+#include "usart.h"
+#include "tim.h"
 
-#define RESPONSE_BUFF_SIZE  32
+#define RESPONSE_BUFF_SIZE  64
 
 const AT_CommandLimit_t AT_CommandLimits[] = {
     {SYS_CMD_TX_FREQ, 150000000, 960000000, 9},    // TX frequency in Hz (100 MHz to 960 MHz, max 9 znaků)
@@ -47,7 +51,13 @@ const AT_CommandLimit_t AT_CommandLimits[] = {
     {SYS_CMD_RF_TX_PERIODIC_NVM, 0, 0, 3},         // RF periodic NVM packet TX control (ON/OFF, max 3 znaky)
     {SYS_CMD_RF_SAVE_PCKT_NVM, 0, 255, 512},       // Save RF packet to NVM (max 512 znaků pro HEX data)
     {SYS_CMD_RF_TX_NVM_ONCE, 1, 1, 1},             // Transmit saved NVM packet once (1, max 1 znak)
-    {SYS_CMD_RF_PERIOD_STATUS, 0, 1, 1}            // Get periodic TX status (0 = FALSE, 1 = TRUE, max 1 znak)
+    {SYS_CMD_RF_PERIOD_STATUS, 0, 1, 1},           // Get periodic TX status (0 = FALSE, 1 = TRUE, max 1 znak)
+    {SYS_CMD_GFSK_BITRATE, NVMA_GFSK_MIN_BITRATE, NVMA_GFSK_MAX_BITRATE, 6},   // GFSK bitrate v bps
+    {SYS_CMD_GFSK_FDEV, NVMA_GFSK_MIN_FDEV, NVMA_GFSK_MAX_FDEV, 6},            // GFSK deviace v Hz
+    {SYS_CMD_GFSK_BW, NVMA_GFSK_MIN_BW, NVMA_GFSK_MAX_BW, 6},                  // GFSK RX sirka pasma (DSB) v Hz
+    {SYS_CMD_GFSK_PREAMBLE, NVMA_GFSK_MIN_PREAMBLE, 65535, 5},                 // GFSK preambule v bitech
+    {SYS_CMD_GFSK_CRC, 0, NVMA_GFSK_MAX_CRC, 1},                               // GFSK typ CRC
+    {SYS_CMD_GFSK_WHITENING, 0, 1, 1}                                          // GFSK whitening (0 = OFF, 1 = ON)
 };
 
 
@@ -61,11 +71,19 @@ static TimerHandle_t rxReconfigTimer = NULL;
 // Timer handle pro periodické RF vysílání
 static TimerHandle_t periodicTxTimer = NULL;
 
+// TX FIFO v RF tasku - pocet paketu odeslanych do RF tasku bez TX done
+static volatile uint8_t txPending = 0;
+static uint16_t txNextId = 1;
+
 
 const uint32_t AllowedBandwidths[] = {7810, 10420, 15630, 20830, 31250, 41670, 62500, 125000, 250000, 500000};
 const size_t AllowedBandwidthCount = sizeof(AllowedBandwidths) / sizeof(AllowedBandwidths[0]);
 
-static void _GSC_Handle_TX(uint8_t *data, uint8_t size);
+static uint16_t _GSC_Handle_TX(uint8_t *data, uint8_t size, uint32_t rfCmd, uint32_t schedUs);
+static bool GSC_QueueTx(uint8_t *data, uint8_t size, uint32_t rfCmd, uint32_t schedUs);
+static bool _GSC_Handle_LBT_CFG(uint8_t *data);
+static bool _GSC_Handle_LRFHSS_CFG(eATCommands cmd, uint8_t *data, uint8_t *cr, uint8_t *bw, uint8_t *grid, uint16_t *hopSeq);
+static void _GSC_GFSK_Param(eATCommands cmd, uint32_t *value, bool set);
 static bool GetCommandLimits(eATCommands cmd, int32_t *minValue, int32_t *maxValue, size_t *maxLength);
 static uint8_t HexStringToByteArray(const char *hexStr, uint8_t *byteArray, size_t byteArraySize);
 static void ByteArrayToHexString(const uint8_t *byteArray, size_t arraySize, char *hexStr, size_t hexStrSize);
@@ -74,6 +92,7 @@ static bool _GSC_Handle_AUX_PIN_PWM(uint8_t *data, uint8_t size);
 static bool _GSC_Handle_AUX_PIN_SET(uint8_t *data, uint8_t size);
 static bool _GSC_Handle_AUX_STOP(uint8_t *data, uint8_t size);
 static void RxReconfigTimerCallback(TimerHandle_t xTimer);
+static uint8_t GSC_RadioConfigScope(eATCommands cmd);
 // static void TriggerRxReconfig(void);  // Currently unused
 void PeriodicTxTimerCallback(TimerHandle_t xTimer);  // Non-static - used in Main_task.c
 static void StartPeriodicTx(void);
@@ -252,6 +271,62 @@ static void RxReconfigTimerCallback(TimerHandle_t xTimer)
 }
 
 
+/**
+ * @brief Which cached radio config (RF task) a setting command changes
+ * 
+ * @param cmd 
+ * @return uint8_t RU_CFG_DIRTY_TX / RU_CFG_DIRTY_RX, 0 = none
+ */
+static uint8_t GSC_RadioConfigScope(eATCommands cmd)
+{
+    switch (cmd)
+    {
+        case SYS_CMD_TX_FREQ:
+        case SYS_CMD_TX_POWER:
+        case SYS_CMD_TX_SF:
+        case SYS_CMD_TX_BW:
+        case SYS_CMD_TX_IQ:
+        case SYS_CMD_TX_CR:
+        case SYS_CMD_TX_SYNCWORD:
+        case SYS_CMD_HEADERMODE_TX:
+        case SYS_CMD_CRC_TX:
+        case SYS_CMD_PREAM_SIZE_TX:
+        case SYS_CMD_TX_LDRO:
+        case SYS_CMD_TX_COMPLETE_SET:
+            return RU_CFG_DIRTY_TX;
+
+        case SYS_CMD_RX_FREQ:
+        case SYS_CMD_RX_SF:
+        case SYS_CMD_RX_BW:
+        case SYS_CMD_RX_IQ:
+        case SYS_CMD_RX_CR:
+        case SYS_CMD_RX_SYNCWORD:
+        case SYS_CMD_HEADERMODE_RX:
+        case SYS_CMD_CRC_RX:
+        case SYS_CMD_PREAM_SIZE_RX:
+        case SYS_CMD_RX_LDRO:
+        case SYS_CMD_RX_PLDLEN:
+        case SYS_CMD_RX_COMPLETE_SET:
+        case SYS_CMD_RX_SNIFF:
+            return RU_CFG_DIRTY_RX;
+
+        // Modem a GFSK parametry plati pro TX i RX
+        case SYS_CMD_RF_MODEM:
+        case SYS_CMD_GFSK_BITRATE:
+        case SYS_CMD_GFSK_FDEV:
+        case SYS_CMD_GFSK_BW:
+        case SYS_CMD_GFSK_PREAMBLE:
+        case SYS_CMD_GFSK_CRC:
+        case SYS_CMD_GFSK_WHITENING:
+        case SYS_CMD_GFSK_SYNC:
+            return RU_CFG_DIRTY_ALL;
+
+        default:
+            return 0;
+    }
+}
+
+
 /**
  * @brief Callback funkce pro periodický TX timer
  * 
@@ -274,7 +349,7 @@ void PeriodicTxTimerCallback(TimerHandle_t xTimer)
     NVMA_Get_LR_TX_RF_PCKT(packet, packetSize);
     
     // Využití existující funkce pro odeslání
-    _GSC_Handle_TX(packet, packetSize);
+    _GSC_Handle_TX(packet, packetSize, CMD_RF_SEND_DATA_NOW, 0);
 }
 
 /**
@@ -621,6 +696,7 @@ bool GSC_ProcessCommand(eATCommands cmd, uint8_t *data, uint16_t size)
     bool isQuery = (data[0] == '?');
     bool hasResponse = false;
     bool commandHandled = true;
+    bool resultSent = false;        // vysledek (OK) uz odeslal handler sam
     bool constrained = false;
     size_t maxLength;
     bool reconfigure_rx = false;
@@ -1345,7 +1421,355 @@ bool GSC_ProcessCommand(eATCommands cmd, uint8_t *data, uint16_t size)
                 break;
             }
             StopPeriodicTx(); // Stop periodic TX if running
-            _GSC_Handle_TX(packet, packetSize);
+            commandHandled = GSC_QueueTx(packet, packetSize, CMD_RF_SEND_DATA_NOW, 0);
+            break;
+        }
+
+        case SYS_CMD_RF_TX_LBT:
+        {   
+            uint8_t packet[256];
+            uint8_t packetSize;
+            packetSize = HexStringToByteArray((char *)data, packet, sizeof(packet));
+            if (packetSize == 0)
+            {
+                AT_SendStringResponse("ERROR: Invalid HEX data\r\n");
+                commandHandled = false;
+                break;
+            }
+            StopPeriodicTx(); // Stop periodic TX if running
+            commandHandled = GSC_QueueTx(packet, packetSize, CMD_RF_SEND_DATA_LBT, 0);
+            break;
+        }
+
+        case SYS_CMD_RF_TX_LRFHSS:
+        {   
+            uint8_t packet[256];
+            uint8_t packetSize;
+            packetSize = HexStringToByteArray((char *)data, packet, sizeof(packet));
+            if (packetSize == 0)
+            {
+                AT_SendStringResponse("ERROR: Invalid HEX data\r\n");
+                commandHandled = false;
+                break;
+            }
+            StopPeriodicTx(); // Stop periodic TX if running
+            commandHandled = GSC_QueueTx(packet, packetSize, CMD_RF_SEND_DATA_LR_FHSS, 0);
+            break;
+        }
+
+        case SYS_CMD_LRFHSS_CR:
+        case SYS_CMD_LRFHSS_BW:
+        case SYS_CMD_LRFHSS_HOPSEQ:
+        {
+            uint8_t cr, bw, grid;
+            uint16_t hopSeq;
+            NVMA_Get_LR_FHSS_Params(&cr, &bw, &grid, &hopSeq);
+
+            if (isQuery)
+            {
+                if (cmd == SYS_CMD_LRFHSS_CR)
+                {
+                    snprintf(response, sizeof(response), "%u\r\n", cr);
+                }
+                else if (cmd == SYS_CMD_LRFHSS_BW)
+                {
+                    snprintf(response, sizeof(response), "%u,%u\r\n", bw, grid);
+                }
+                else if (hopSeq == NVMA_LR_FHSS_HOP_SEQ_RANDOM)
+                {
+                    snprintf(response, sizeof(response), "RND\r\n");
+                }
+                else
+                {
+                    snprintf(response, sizeof(response), "%u\r\n", hopSeq);
+                }
+                hasResponse = true;
+            }
+            else if (!_GSC_Handle_LRFHSS_CFG(cmd, data, &cr, &bw, &grid, &hopSeq))
+            {
+                AT_SendStringResponse("ERROR: Invalid LR-FHSS value\r\n");
+                commandHandled = false;
+            }
+            else
+            {
+                // RF task nacita LR-FHSS parametry z NVM pro kazdy paket
+                NVMA_Set_LR_FHSS_Params(cr, bw, grid, hopSeq);
+            }
+            break;
+        }
+
+        case SYS_CMD_RF_MODEM:
+        {
+            uint8_t modem;
+            if (isQuery)
+            {
+                NVMA_Get_RF_Modem(&modem);
+                snprintf(response, sizeof(response), "%s\r\n", (modem == RF_MODEM_GFSK) ? "GFSK" : "LORA");
+                hasResponse = true;
+            }
+            else
+            {
+                if (strcasecmp((char*)data, "LORA") == 0)
+                {
+                    NVMA_Set_RF_Modem(RF_MODEM_LORA);
+                }
+                else if (strcasecmp((char*)data, "GFSK") == 0)
+                {
+                    NVMA_Set_RF_Modem(RF_MODEM_GFSK);
+                }
+                else
+                {
+                    AT_SendStringResponse("ERROR: Invalid modem. Use LORA or GFSK\r\n");
+                    commandHandled = false;
+                    break;
+                }
+                reconfigure_rx = true;
+            }
+            break;
+        }
+
+        case SYS_CMD_GFSK_BITRATE:
+        case SYS_CMD_GFSK_FDEV:
+        case SYS_CMD_GFSK_BW:
+        case SYS_CMD_GFSK_PREAMBLE:
+        case SYS_CMD_GFSK_CRC:
+        case SYS_CMD_GFSK_WHITENING:
+        {
+            uint32_t value;
+            if (isQuery)
+            {
+                _GSC_GFSK_Param(cmd, &value, false);
+                AT_FormatUint32Response(value, (uint8_t *)response, &response_size);
+                hasResponse = true;
+            }
+            else
+            {
+                if (!GetCommandLimits(cmd, &minValue, &maxValue, &maxLength))
+                {
+                    AT_SendStringResponse("ERROR: Command not found\r\n");
+                    commandHandled = false;
+                    break;
+                }
+
+                if (!AT_ParseUint32(data, &value, maxLength))
+                {
+                    AT_SendStringResponse("ERROR: Invalid GFSK value\r\n");
+                    commandHandled = false;
+                    break;
+                }
+
+                if ((value < (uint32_t)minValue) || (value > (uint32_t)maxValue))
+                {
+                    AT_SendStringResponse("ERROR: GFSK value out of limit\r\n");
+                    commandHandled = false;
+                    break;
+                }
+
+                _GSC_GFSK_Param(cmd, &value, true);
+                reconfigure_rx = true;
+            }
+            break;
+        }
+
+        case SYS_CMD_GFSK_SYNC:
+        {
+            uint8_t sync[NVMA_GFSK_MAX_SYNC_LEN];
+            uint8_t syncLen;
+            if (isQuery)
+            {
+                NVMA_Get_GFSK_SyncWord(sync, &syncLen);
+                ByteArrayToHexString(sync, syncLen, response, sizeof(response) - 2);
+                strcat(response, "\r\n");
+                hasResponse = true;
+            }
+            else
+            {
+                syncLen = HexStringToByteArray((char *)data, sync, sizeof(sync));
+                if ((syncLen == 0) || (strlen((char *)data) != (size_t)(syncLen * 2)))
+                {
+                    AT_SendStringResponse("ERROR: Use AT+GFSK_SYNC=<2-16 HEX digits>\r\n");
+                    commandHandled = false;
+                    break;
+                }
+                NVMA_Set_GFSK_SyncWord(sync, syncLen);
+                reconfigure_rx = true;
+            }
+            break;
+        }
+
+        case SYS_CMD_LRFHSS_SYNC:
+        {
+            uint32_t sync;
+            uint8_t syncBytes[4];
+            if (isQuery)
+            {
+                NVMA_Get_LR_FHSS_Sync(&sync);
+                snprintf(response, sizeof(response), "%08lX\r\n", (unsigned long)sync);
+                hasResponse = true;
+            }
+            else if ((strlen((char *)data) != 8) || (HexStringToByteArray((char *)data, syncBytes, sizeof(syncBytes)) != sizeof(syncBytes)))
+            {
+                AT_SendStringResponse("ERROR: Use AT+LRFHSS_SYNC=<8 HEX digits>\r\n");
+                commandHandled = false;
+            }
+            else
+            {
+                sync = ((uint32_t)syncBytes[0] << 24) | ((uint32_t)syncBytes[1] << 16) | ((uint32_t)syncBytes[2] << 8) | syncBytes[3];
+                NVMA_Set_LR_FHSS_Sync(sync);
+            }
+            break;
+        }
+
+        case SYS_CMD_RF_LBT_CFG:
+        {
+            if (isQuery)
+            {
+                uint8_t symb, detPeak, detMin, attempts;
+                uint16_t backoff;
+                NVMA_Get_LR_CAD_Params(&symb, &detPeak, &detMin);
+                NVMA_Get_LR_LBT_Params(&attempts, &backoff);
+                snprintf(response, sizeof(response), "+LBT_CFG:%u,%u,%u,%u,%u\r\n", symb, detPeak, detMin, attempts, backoff);
+                hasResponse = true;
+            }
+            else if (!_GSC_Handle_LBT_CFG(data))
+            {
+                AT_SendStringResponse("ERROR: Use AT+RF_LBT_CFG=<symb:1|2|4|8|16>,<det_peak>,<det_min>,<attempts:1-16>,<backoff_ms:1-10000>\r\n");
+                commandHandled = false;
+            }
+            break;
+        }
+
+        case SYS_CMD_RX_SNIFF:
+        {
+            uint8_t sniff;
+            uint8_t modem;
+            uint32_t rxMs = 0;
+            uint32_t sleepMs = 0;
+            ralf_params_lora_t rxParam;
+
+            memset(&rxParam, 0, sizeof(rxParam));
+            ru_load_radio_config_rx(&rxParam);
+            NVMA_Get_RF_Modem(&modem);
+
+            if (isQuery)
+            {
+                NVMA_Get_LR_RX_Sniff(&sniff);
+                if ((sniff == 1) && (modem != RF_MODEM_LORA))
+                {
+                    // Sniff jen pro LoRa - v GFSK RF task posloucha continuous
+                    sniff = 0;
+                }
+                else if ((sniff == 1) && !ru_calculate_sniff_timing(&rxParam, &rxMs, &sleepMs))
+                {
+                    // Preambule se mezitim zkratila - RF task posloucha continuous
+                    sniff = 0;
+                }
+                snprintf(response, sizeof(response), "+RX_SNIFF:%u,%lu,%lu\r\n", sniff, (unsigned long)rxMs, (unsigned long)sleepMs);
+                hasResponse = true;
+            }
+            else
+            {
+                if (!ParseBoolValue((char *)data, &sniff))
+                {
+                    AT_SendStringResponse("ERROR: Invalid RX_SNIFF value\r\n");
+                    commandHandled = false;
+                    break;
+                }
+
+                if ((sniff == 1) && (modem != RF_MODEM_LORA))
+                {
+                    AT_SendStringResponse("ERROR: RX sniff needs LoRa modem\r\n");
+                    commandHandled = false;
+                    break;
+                }
+
+                if ((sniff == 1) && !ru_calculate_sniff_timing(&rxParam, &rxMs, &sleepMs))
+                {
+                    AT_SendStringResponse("ERROR: RX preamble too short for sniff\r\n");
+                    commandHandled = false;
+                    break;
+                }
+
+                NVMA_Set_LR_RX_Sniff(sniff);
+                reconfigure_rx = true;
+            }
+            break;
+        }
+
+        case SYS_CMD_RF_LBT_STAT:
+        {
+            const ru_lbt_stats_t *stats = ru_get_lbt_stats();
+            snprintf(response, sizeof(response), "+LBT_STAT:%lu,%lu,%lu,%lu\r\n",
+                     (unsigned long)stats->cadRuns, (unsigned long)stats->busy,
+                     (unsigned long)stats->sent, (unsigned long)stats->dropped);
+            hasResponse = true;
+            break;
+        }
+
+        case SYS_CMD_RF_TX_SCHED:
+        {
+            uint8_t packet[256];
+            uint8_t packetSize;
+            uint32_t schedUs;
+            uint32_t now = TIM_GetTimestampUs();
+            bool relative;
+            char *hex;
+
+            if (isQuery)
+            {
+                // Aktualni cas - host si podle nej zarovna sloty na casovou zakladnu dongle
+                snprintf(response, sizeof(response), "+TIME:%lu\r\n", (unsigned long)now);
+                hasResponse = true;
+                break;
+            }
+
+            hex = strchr((char *)data, ',');
+            if (hex == NULL)
+            {
+                AT_SendStringResponse("ERROR: Use AT+RF_TX_SCHED=<[+]time_us>,<HEX data>\r\n");
+                commandHandled = false;
+                break;
+            }
+            *hex++ = '\0';
+
+            relative = (data[0] == '+');
+            if (AT_ParseUint32(&data[relative ? 1 : 0], &schedUs, 10) == 0)
+            {
+                AT_SendStringResponse("ERROR: Invalid TX time\r\n");
+                commandHandled = false;
+                break;
+            }
+            if (relative)
+            {
+                schedUs += now;
+            }
+
+            if (((int32_t)(schedUs - now) < RU_SCHED_MIN_LEAD_US) || ((schedUs - now) > RU_SCHED_MAX_AHEAD_US))
+            {
+                AT_SendStringResponse("ERROR: TX time must be 3 ms to 600 s ahead\r\n");
+                commandHandled = false;
+                break;
+            }
+
+            packetSize = HexStringToByteArray(hex, packet, sizeof(packet));
+            if (packetSize == 0)
+            {
+                AT_SendStringResponse("ERROR: Invalid HEX data\r\n");
+                commandHandled = false;
+                break;
+            }
+            StopPeriodicTx(); // Stop periodic TX if running
+            commandHandled = GSC_QueueTx(packet, packetSize, CMD_RF_SEND_DATA_SCHED, schedUs);
+            break;
+        }
+
+        case SYS_CMD_RF_SCHED_STAT:
+        {
+            const ru_sched_stats_t *stats = ru_get_sched_stats();
+            snprintf(response, sizeof(response), "+SCHED_STAT:%lu,%lu,%lu,%ld,%ld\r\n",
+                     (unsigned long)stats->sent, (unsigned long)stats->late, (unsigned long)stats->deferred,
+                     (long)stats->lastJitterUs, (long)stats->maxJitterUs);
+            hasResponse = true;
             break;
         }
 
@@ -1364,7 +1788,7 @@ bool GSC_ProcessCommand(eATCommands cmd, uint8_t *data, uint16_t size)
 
             StopPeriodicTx(); // Stop periodic TX if running
             memcpy(packet, data, packetSize);
-            _GSC_Handle_TX(packet, packetSize);
+            commandHandled = GSC_QueueTx(packet, packetSize, CMD_RF_SEND_DATA_NOW, 0);
             break;
         }
 
@@ -1396,7 +1820,7 @@ bool GSC_ProcessCommand(eATCommands cmd, uint8_t *data, uint16_t size)
                     uint16_t packetSize;
                     NVMA_Get_LR_Saved_Pckt_Size(&packetSize);
                     NVMA_Get_LR_TX_RF_PCKT(packet,packetSize);
-                    _GSC_Handle_TX(packet, packetSize);
+                    commandHandled = GSC_QueueTx(packet, packetSize, CMD_RF_SEND_DATA_NOW, 0);
                 }
                 else 
                 {
@@ -1622,6 +2046,49 @@ bool GSC_ProcessCommand(eATCommands cmd, uint8_t *data, uint16_t size)
             break;
         }
 
+        case SYS_CMD_RF_RX_STAT:
+        {
+            const ru_rx_stats_t *stats = ru_get_rx_stats();
+            snprintf(response, sizeof(response), "+RX_STAT:%lu,%lu,%lu,%lu,%lu\r\n",
+                     (unsigned long)stats->packets, (unsigned long)stats->fastRearms,
+                     (unsigned long)stats->fullRearms, (unsigned long)stats->lastGapUs,
+                     (unsigned long)stats->maxGapUs);
+            hasResponse = true;
+            break;
+        }
+
+        case SYS_CMD_RF_POOL_STAT:
+        {
+            pkt_pool_stats_t stats;
+            pkt_pool_get_stats(&stats);
+            snprintf(response, sizeof(response), "+POOL_STAT:%u,%u,%lu,%u,%u,%lu\r\n",
+                     stats.used[PKT_POOL_RX], stats.highWater[PKT_POOL_RX], (unsigned long)stats.exhausted[PKT_POOL_RX],
+                     stats.used[PKT_POOL_TX], stats.highWater[PKT_POOL_TX], (unsigned long)stats.exhausted[PKT_POOL_TX]);
+            hasResponse = true;
+            break;
+        }
+
+        case SYS_CMD_RF_BUSY_STAT:
+        {
+            const sx126x_hal_busy_stats_t *stats = sx126x_hal_get_busy_stats();
+            snprintf(response, sizeof(response), "+BUSY_STAT:%lu,%lu,%lu,%lu,%lu,%lu\r\n",
+                     (unsigned long)stats->waits, (unsigned long)stats->blocked, (unsigned long)stats->timeouts,
+                     (unsigned long)stats->last_us, (unsigned long)stats->max_us, (unsigned long)ru_get_recoveries());
+            hasResponse = true;
+            break;
+        }
+
+        case SYS_CMD_RF_SPI_STAT:
+        {
+            const sx126x_hal_spi_stats_t *stats = sx126x_hal_get_spi_stats();
+            snprintf(response, sizeof(response), "+SPI_STAT:%lu,%lu,%lu,%lu,%lu,%lu,%lu\r\n",
+                     (unsigned long)stats->transactions, (unsigned long)stats->busy_checks, (unsigned long)stats->locks,
+                     (unsigned long)stats->batches, (unsigned long)stats->last_batch_xfers, (unsigned long)stats->last_batch_checks,
+                     (unsigned long)stats->errors);
+            hasResponse = true;
+            break;
+        }
+
         case SYS_CMD_RF_GET_TSYM:
         {
             uint32_t tsym_us = ru_calculate_symbol_time_us();
@@ -1743,15 +2210,32 @@ bool GSC_ProcessCommand(eATCommands cmd, uint8_t *data, uint16_t size)
         case SYS_CMD_UART_BAUD:
         {
             uint32_t baud;
+            bool temporary = false;
+            char *option;
+
             if (isQuery)
             {
-                NVMA_Get_UART_Baud(&baud);
-                snprintf(response, sizeof(response), "%lu\r\n", baud);
+                // Aktualni rychlost (muze byt docasna, neulozena v NVM)
+                snprintf(response, sizeof(response), "%lu\r\n", (unsigned long)huart1.Init.BaudRate);
                 hasResponse = true;
             }
             else
             {
-                if (!AT_ParseUint32(data, &baud, 6))  // max 921600 = 6 digits
+                // =<baud>[,TEMP] - TEMP = neukladat do NVM, po restartu plati ulozena rychlost
+                option = strchr((char *)data, ',');
+                if (option != NULL)
+                {
+                    *option++ = '\0';
+                    if (strcasecmp(option, "TEMP") != 0)
+                    {
+                        AT_SendStringResponse("ERROR: Invalid UART_BAUD option, use TEMP\r\n");
+                        commandHandled = false;
+                        break;
+                    }
+                    temporary = true;
+                }
+
+                if (!AT_ParseUint32(data, &baud, 7))  // max 2000000 = 7 digits
                 {
                     AT_SendStringResponse("ERROR: Invalid UART_BAUD value\r\n");
                     commandHandled = false;
@@ -1760,16 +2244,27 @@ bool GSC_ProcessCommand(eATCommands cmd, uint8_t *data, uint16_t size)
                 
                 if (!NVMA_Is_Valid_Baud(baud))
                 {
-                    AT_SendStringResponse("ERROR: Invalid baud rate. Use: 9600, 19200, 38400, 57600, 115200, 230400\r\n");
+                    AT_SendStringResponse("ERROR: Invalid baud rate. Use: 9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600, 1000000, 2000000\r\n");
                     commandHandled = false;
                     break;
                 }
                 
-                NVMA_Set_UART_Baud(baud);
+                // Predchozi odpovedi musi odejit drive nez OK - jinak by se prepnuti nestihlo
+                if (!AT_TxFlush(AT_BAUD_FLUSH_TIMEOUT_MS))
+                {
+                    AT_SendStringResponse("ERROR: UART busy\r\n");
+                    commandHandled = false;
+                    break;
+                }
+
+                // OK jeste starou rychlosti, potom prepnuti bez restartu a "+BAUD:<rate>" s platnou rychlosti
                 AT_SendStringResponse("OK\r\n");
-                // Small delay to let response be sent before restart
-                osDelay(100);
-                NVIC_SystemReset();
+                resultSent = true;
+                if (AT_ChangeBaudRate(baud) && !temporary)
+                {
+                    // Uklada se jen rychlost, ktera opravdu funguje
+                    NVMA_Set_UART_Baud(baud);
+                }
             }
             break;
         }
@@ -1816,7 +2311,7 @@ bool GSC_ProcessCommand(eATCommands cmd, uint8_t *data, uint16_t size)
     }
     else
     {
-        if (commandHandled == false)
+        if ((commandHandled == false) || resultSent)
         {
           //
         }
@@ -1826,6 +2321,16 @@ bool GSC_ProcessCommand(eATCommands cmd, uint8_t *data, uint16_t size)
         }
     }
 
+    // RF task drzi parametry v RAM - po zmene v NVM je musi znovu nacist
+    if ((isQuery == false) && (GSC_RadioConfigScope(cmd) != 0))
+    {
+        dataQueue_t txm;
+        txm.ptr = NULL;
+        txm.cmd = CMD_RF_RADIO_CFG_DIRTY;
+        txm.data = GSC_RadioConfigScope(cmd);
+        xQueueSend(queueRadioHandle, &txm, portMAX_DELAY);
+    }
+
     if(reconfigure_rx == true)
     {
         RxReconfigTimerCallback(NULL);
@@ -1843,33 +2348,101 @@ bool GSC_ProcessCommand(eATCommands cmd, uint8_t *data, uint16_t size)
  * @return true 
  * @return false 
  */
-static void _GSC_Handle_TX(uint8_t *data, uint8_t size)
+static uint16_t _GSC_Handle_TX(uint8_t *data, uint8_t size, uint32_t rfCmd, uint32_t schedUs)
 {   
     dataQueue_t     txm;
     packet_info_t	*tx_pkt;
-    uint8_t         *tx_raw_data;
+    uint16_t        id;
 
-    tx_raw_data =  pvPortMalloc(size);
-    if (tx_raw_data == NULL)
+    // Volano z main tasku i z timer tasku (periodicke TX)
+    taskENTER_CRITICAL();
+    if (txPending >= RF_TX_FIFO_SIZE)
+    {
+        taskEXIT_CRITICAL();
+        return 0;
+    }
+    txPending++;
+    id = txNextId++;
+    if (txNextId == 0)
     {
-        _exit(313513);
+        txNextId = 1;
     }
+    taskEXIT_CRITICAL();
 
-    memcpy(tx_raw_data, data, size);
-
-    tx_pkt = pvPortMalloc(sizeof(packet_info_t));
+    // TX kvota poolu = RF_TX_FIFO_SIZE, po kontrole txPending by alokace nemela selhat
+    tx_pkt = pkt_pool_alloc(PKT_POOL_TX);
     if (tx_pkt == NULL)
     {
-        _exit(314687);
+        taskENTER_CRITICAL();
+        txPending--;
+        taskEXIT_CRITICAL();
+        return 0;
     }
-    
-    tx_pkt->packet = tx_raw_data;
+
+    memcpy(tx_pkt->packet, data, size);
     tx_pkt->size = size;
+    tx_pkt->id = id;
+    tx_pkt->sched_us = schedUs;
     
     txm.ptr = tx_pkt;
-    txm.cmd = CMD_RF_SEND_DATA_NOW;
+    txm.cmd = rfCmd;
 
     xQueueSend(queueRadioHandle,&txm,portMAX_DELAY);
+
+    return id;
+}
+
+/**
+ * @brief Queue packet for TX and answer +TXID:<id> to AT command
+ * 
+ * @param data 
+ * @param size 
+ * @param rfCmd CMD_RF_SEND_DATA_NOW / _LBT / _LR_FHSS / _SCHED
+ * @param schedUs TX time for CMD_RF_SEND_DATA_SCHED
+ * @return true 
+ * @return false TX FIFO full
+ */
+static bool GSC_QueueTx(uint8_t *data, uint8_t size, uint32_t rfCmd, uint32_t schedUs)
+{
+    char response[RESPONSE_BUFF_SIZE];
+    uint16_t id;
+
+    id = _GSC_Handle_TX(data, size, rfCmd, schedUs);
+    if (id == 0)
+    {
+        AT_SendStringResponse("ERROR: TX FIFO full\r\n");
+        return false;
+    }
+
+    snprintf(response, sizeof(response), "+TXID:%u\r\n", id);
+    AT_SendStringResponse(response);
+    return true;
+}
+
+/**
+ * @brief Send RF packet (used by binary host protocol and stream mode)
+ * 
+ * @param data 
+ * @param size 
+ * @return uint16_t packet ID, 0 = TX FIFO full
+ */
+uint16_t GSC_SendRfPacket(uint8_t *data, uint8_t size)
+{
+    return _GSC_Handle_TX(data, size, CMD_RF_SEND_DATA_NOW, 0);
+}
+
+/**
+ * @brief TX done / dropped reported by RF task - main task context
+ * 
+ */
+void GSC_TxDone(void)
+{
+    taskENTER_CRITICAL();
+    if (txPending > 0)
+    {
+        txPending--;
+    }
+    taskEXIT_CRITICAL();
 }
 
 /**
@@ -1975,6 +2548,138 @@ static bool _GSC_Handle_AUX_PIN_PWM(uint8_t *data, uint8_t size)
 }
 
 
+/**
+ * @brief AT+RF_LBT_CFG=<symb>,<det_peak>,<det_min>,<attempts>,<backoff_ms>
+ * 
+ * @param data 
+ * @return true 
+ * @return false 
+ */
+static bool _GSC_Handle_LBT_CFG(uint8_t *data)
+{
+    uint8_t symb, detPeak, detMin, attempts;
+    uint16_t backoff;
+
+    char *token = strtok((char*)data, ",");
+    if (!token || !AT_ParseUint8((uint8_t*)token, &symb, 2) || !NVMA_Is_Valid_CAD_Symb(symb))
+        return false;
+
+    token = strtok(NULL, ",");
+    if (!token || !AT_ParseUint8((uint8_t*)token, &detPeak, 3))
+        return false;
+
+    token = strtok(NULL, ",");
+    if (!token || !AT_ParseUint8((uint8_t*)token, &detMin, 3))
+        return false;
+
+    token = strtok(NULL, ",");
+    if (!token || !AT_ParseUint8((uint8_t*)token, &attempts, 2) || attempts == 0 || attempts > NVMA_LBT_MAX_ATTEMPTS)
+        return false;
+
+    token = strtok(NULL, ",");
+    if (!token || !AT_ParseUint16((uint8_t*)token, &backoff, 5) || backoff == 0 || backoff > NVMA_LBT_MAX_BACKOFF_MS)
+        return false;
+
+    if (strtok(NULL, ",") != NULL)
+        return false;
+
+    NVMA_Set_LR_CAD_Params(symb, detPeak, detMin);
+    NVMA_Set_LR_LBT_Params(attempts, backoff);
+
+    return true;
+}
+
+/**
+ * @brief Get / set numeric GFSK parameter in NVM (limits checked by caller)
+ *
+ * @param cmd SYS_CMD_GFSK_*
+ * @param value 
+ * @param set 
+ */
+static void _GSC_GFSK_Param(eATCommands cmd, uint32_t *value, bool set)
+{
+    uint16_t u16;
+    uint8_t u8;
+
+    switch (cmd)
+    {
+        case SYS_CMD_GFSK_BITRATE:
+            if (set) NVMA_Set_GFSK_Bitrate(*value); else NVMA_Get_GFSK_Bitrate(value);
+            break;
+
+        case SYS_CMD_GFSK_FDEV:
+            if (set) NVMA_Set_GFSK_Fdev(*value); else NVMA_Get_GFSK_Fdev(value);
+            break;
+
+        case SYS_CMD_GFSK_BW:
+            if (set) NVMA_Set_GFSK_BW(*value); else NVMA_Get_GFSK_BW(value);
+            break;
+
+        case SYS_CMD_GFSK_PREAMBLE:
+            if (set) { NVMA_Set_GFSK_Preamble((uint16_t)*value); } else { NVMA_Get_GFSK_Preamble(&u16); *value = u16; }
+            break;
+
+        case SYS_CMD_GFSK_CRC:
+            if (set) { NVMA_Set_GFSK_CRC((uint8_t)*value); } else { NVMA_Get_GFSK_CRC(&u8); *value = u8; }
+            break;
+
+        case SYS_CMD_GFSK_WHITENING:
+            if (set) { NVMA_Set_GFSK_Whitening((uint8_t)*value); } else { NVMA_Get_GFSK_Whitening(&u8); *value = u8; }
+            break;
+
+        default:
+            *value = 0;
+            break;
+    }
+}
+
+/**
+ * @brief AT+LRFHSS_CR=<0-3>, AT+LRFHSS_BW=<bw:0-9>,<grid:0|1>, AT+LRFHSS_HOPSEQ=<0-511>|RND
+ *
+ * @param cmd 
+ * @param data 
+ * @param cr 
+ * @param bw 
+ * @param grid 
+ * @param hopSeq 
+ * @return true values updated (not yet saved)
+ * @return false 
+ */
+static bool _GSC_Handle_LRFHSS_CFG(eATCommands cmd, uint8_t *data, uint8_t *cr, uint8_t *bw, uint8_t *grid, uint16_t *hopSeq)
+{
+    char *token;
+
+    switch (cmd)
+    {
+        case SYS_CMD_LRFHSS_CR:
+            return AT_ParseUint8(data, cr, 1) && (*cr <= NVMA_LR_FHSS_MAX_CR);
+
+        case SYS_CMD_LRFHSS_BW:
+            token = strtok((char*)data, ",");
+            if (!token || !AT_ParseUint8((uint8_t*)token, bw, 1) || *bw > NVMA_LR_FHSS_MAX_BW)
+                return false;
+
+            token = strtok(NULL, ",");
+            if (!token || !AT_ParseUint8((uint8_t*)token, grid, 1) || *grid > NVMA_LR_FHSS_MAX_GRID)
+                return false;
+
+            return (strtok(NULL, ",") == NULL);
+
+        case SYS_CMD_LRFHSS_HOPSEQ:
+            if (strcasecmp((char*)data, "RND") == 0)
+            {
+                *hopSeq = NVMA_LR_FHSS_HOP_SEQ_RANDOM;
+                return true;
+            }
+            // Grid 25 kHz ma jen 384 sekvenci - RF task pouzije hopSeq % pocet
+            return AT_ParseUint16(data, hopSeq, 3) && (*hopSeq <= NVMA_LR_FHSS_MAX_HOP_SEQ);
+
+        default:
+            return false;
+    }
+}
+
+
 static bool _GSC_Handle_AUX_STOP(uint8_t *data, uint8_t size)
 {
     (void)size;
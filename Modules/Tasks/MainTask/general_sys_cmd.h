@@ -26,6 +26,8 @@ typedef struct {
 
 bool GSC_ProcessCommand(eATCommands cmd, uint8_t *data, uint16_t size);
 void GSC_SetPeriodicTxTimer(TimerHandle_t timer);
+uint16_t GSC_SendRfPacket(uint8_t *data, uint8_t size);
+void GSC_TxDone(void);
 
 #endif // GENERAL_SYS_CMD_H
 
@@ -8,6 +8,9 @@
 #include "main.h"
 #include "RF_Task.h"
 #include "radio_user.h"
+#include "pkt_pool.h"
+#include "sx126x_hal.h"
+#include "NVMA.h"
 
 
 extern osMessageQueueId_t queueRadioHandle;
@@ -39,6 +42,44 @@ static void _RF_EventLed_Callback(TimerHandle_t timer)
 	HW_LED_RF_EVENT_OFF();
 }
 
+/**
+ * @brief LBT backoff expired
+ * 
+ * @param timer 
+ */
+static void _RF_LbtBackoff_Callback(TimerHandle_t timer)
+{
+	UNUSED(timer);
+	dataQueue_t txm;
+	txm.ptr = NULL;
+
+	txm.cmd = CMD_RF_LBT_RETRY;
+	xQueueSend(queueRadioHandle,&txm,portMAX_DELAY);
+}
+
+/**
+ * @brief Packet was not queued - return it to pool and report failed TX to main task
+ * 
+ * @param rxd 
+ */
+static void _RF_TxReject(dataQueue_t *rxd)
+{
+	dataQueue_t	sd;
+	packet_info_t *pkt = rxd->ptr;
+
+	sd.cmd = CMD_MAIN_RF_TX_DONE;
+	sd.ptr = NULL;
+	sd.data = 0;
+	sd.tmp_16 = pkt->id;
+	sd.tmp_32 = 0;
+	sd.tmp_bool = false;
+
+	// Slot vratit driv, nez main task uvolni misto v txPending
+	pkt_pool_free(pkt);
+	rxd->ptr = NULL;
+	xQueueSend(queueMainHandle, &sd, portMAX_DELAY);
+}
+
 /*
  *
  */
@@ -72,6 +113,18 @@ void radio_task_off(radio_context_t *ctx,dataQueue_t *rxd)
 			ctx->rfTaskState.currentState = RF_TASK_OFF;
 			break;
 
+		case CMD_RF_RADIO_CFG_DIRTY:
+			ru_radio_config_dirty(ctx, rxd->data);
+			break;
+
+		case CMD_RF_SEND_DATA_NOW:
+		case CMD_RF_SEND_DATA_LBT:
+		case CMD_RF_SEND_DATA_LR_FHSS:
+		case CMD_RF_SEND_DATA_SCHED:
+			// Radio je vypnute
+			_RF_TxReject(rxd);
+			break;
+
 		default:
 			break;
 	}
@@ -89,6 +142,7 @@ void radio_task_on(radio_context_t *ctx, dataQueue_t *rxd)
 	switch (rxd->cmd)
 	{
 		case CMD_RF_TURN_ON:
+			ru_tx_fifo_flush(ctx);
 			ru_radio_process_commands(RADIO_CMD_INIT,ctx,rxd);
 			ru_radio_process_commands(RADIO_CMD_START_RX, ctx, rxd);
 
@@ -100,6 +154,7 @@ void radio_task_on(radio_context_t *ctx, dataQueue_t *rxd)
 			break;
 
 		case CMD_RF_TURN_OFF:
+			ru_tx_fifo_flush(ctx);
 			ru_radio_process_commands(RADIO_CMD_SLEEP,ctx,rxd);
 
 			sd.cmd = CMD_CORE_RF_IS_OFF;
@@ -110,17 +165,40 @@ void radio_task_on(radio_context_t *ctx, dataQueue_t *rxd)
 			break;
 
 		case CMD_RF_IRQ_FIRED:
-			ru_radio_process_IRQ(ctx);
+			// tmp_32 = cas DIO1 IRQ [us] z EXTI
+			ru_radio_process_IRQ(ctx, rxd->tmp_32);
 			break;
 
 		case CMD_RF_SEND_DATA_NOW:
-			ru_radio_process_commands(RADIO_CMD_SEND_UNIVERSAL_PAYLOAD_NOW,ctx,rxd);
+		case CMD_RF_SEND_DATA_LBT:
+		case CMD_RF_SEND_DATA_LR_FHSS:
+		case CMD_RF_SEND_DATA_SCHED:
+			// Paket prebira TX FIFO - uvolni se az po TX done
+			switch (rxd->cmd)
+			{
+				case CMD_RF_SEND_DATA_LBT:		((packet_info_t *)rxd->ptr)->txMode = RU_TX_MODE_LBT; break;
+				case CMD_RF_SEND_DATA_LR_FHSS:	((packet_info_t *)rxd->ptr)->txMode = RU_TX_MODE_LR_FHSS; break;
+				case CMD_RF_SEND_DATA_SCHED:	((packet_info_t *)rxd->ptr)->txMode = RU_TX_MODE_SCHED; break;
+				default:						((packet_info_t *)rxd->ptr)->txMode = RU_TX_MODE_NOW; break;
+			}
+			if (ru_tx_fifo_push(ctx, rxd->ptr))
+			{
+				rxd->ptr = NULL;
+			}
+			else
+			{
+				_RF_TxReject(rxd);
+			}
 			break;
 
 		case CMD_RF_RADIO_RX_TO_UART:
 			if (rxd->data == 1)
 			{
-				ru_radio_process_commands(RADIO_CMD_START_RX,ctx,rxd);
+				// Behem TX FIFO se RX spusti az po poslednim paketu
+				if (ctx->txFifo.count == 0)
+				{
+					ru_radio_process_commands(RADIO_CMD_START_RX,ctx,rxd);
+				}
 				ctx->rx_to_uart = true;
 			}
 			else
@@ -131,8 +209,31 @@ void radio_task_on(radio_context_t *ctx, dataQueue_t *rxd)
 			
 			break;
 
+		case CMD_RF_RADIO_CFG_DIRTY:
+			// Nacte se z NVM az pri dalsim TX / RX
+			ru_radio_config_dirty(ctx, rxd->data);
+			break;
+
 		case CMD_RF_RADIO_RECONFIG_RX:
-			ru_radio_process_commands(RADIO_CMD_START_RX,ctx,rxd);
+			ru_radio_config_dirty(ctx, RU_CFG_DIRTY_RX);
+			if (ctx->txFifo.count == 0)
+			{
+				ru_radio_process_commands(RADIO_CMD_START_RX,ctx,rxd);
+			}
+			break;
+
+		case CMD_RF_LBT_RETRY:
+			ru_lbt_retry(ctx);
+			break;
+
+		case CMD_RF_SCHED_PRELOAD:
+			// RU_SCHED_PRELOAD_US pred slotem - konec RX, payload do SX126x
+			ru_sched_preload(ctx);
+			break;
+
+		case CMD_RF_SCHED_FIRE:
+			// Cas slotu nastal behem SPI transakce tasku
+			ru_sched_fire(ctx);
 			break;
 
 		case CMD_RF_HB_REQUEST:
@@ -142,6 +243,7 @@ void radio_task_on(radio_context_t *ctx, dataQueue_t *rxd)
 			break;
 
 		case CMD_RF_TX_CW:
+			ru_tx_fifo_flush(ctx);
 			if (rxd->data == 1)
 			{
 				// Start TX CW mode
@@ -172,16 +274,23 @@ void radio_task(void)
 	radio_context_t ctx;
 	ctx.rfTaskState.currentState = RF_TASK_ON;
 	ctx.rfTaskState.previousState = RF_TASK_ON;
+	memset(&ctx.txFifo, 0, sizeof(ctx.txFifo));
 
 	ctx.timers.rfHBTimer.timer = xTimerCreateStatic("RF_TimerHeartBeat", pdMS_TO_TICKS(RF_HEART_BEAT_TIMEOUT_MS),
    	    		pdFALSE, NULL, _RF_HeartBeat_Callback,  &ctx.timers.rfHBTimer.timerPlace);
 	ctx.timers.rfEventLedTimer.timer = xTimerCreateStatic("RF_Event_LED", pdMS_TO_TICKS(RF_EVENT_LED_TIMEOUT_MS), 
 							pdFALSE, NULL, _RF_EventLed_Callback, &ctx.timers.rfEventLedTimer.timerPlace);
+	ctx.timers.rfLbtTimer.timer = xTimerCreateStatic("RF_LBT", pdMS_TO_TICKS(NVMA_DEFAULT_LBT_BACKOFF_MS),
+							pdFALSE, NULL, _RF_LbtBackoff_Callback, &ctx.timers.rfLbtTimer.timerPlace);
 
 	ru_sx1262_assign(&ctx);
 
 	if(ru_radioInit(&ctx) == false)	_exit(48351);
 	ru_radio_start_rx(&ctx);
+	if (sx126x_hal_take_fault())
+	{
+		if (ru_radio_recover(&ctx, true) == false)	_exit(48352);
+	}
 
 	for(;;)
 	{
@@ -189,9 +298,15 @@ void radio_task(void)
 		if (ret == pdPASS)
 		{
 			radio_states[ctx.rfTaskState.currentState](&ctx, &rxd);
-			/* Clear malloc */
-			vPortFree(rxd.ptr);
+			/* Vratit paket do poolu */
+			pkt_pool_free(rxd.ptr);
 			rxd.ptr=NULL;
+
+			/* BUSY se neuvolnil, selhal SPI prenos nebo start RX/CAD - reset radia a obnova stavu tasku */
+			if (sx126x_hal_take_fault())
+			{
+				if (ru_radio_recover(&ctx, ctx.rfTaskState.currentState == RF_TASK_ON) == false)	_exit(48352);
+			}
 		}
 	}
 }
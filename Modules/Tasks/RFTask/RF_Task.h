@@ -11,9 +11,11 @@
 #include "main.h"
 #include "ralf_defs.h"
 #include "ralf.h"
+#include "NVMA.h"
 
 
 #define RF_CNT			1
+#define RF_TX_FIFO_SIZE	4		// pakety cekajici na vysilani (vcetne prave vysilaneho)
 
 typedef enum
 {
@@ -76,6 +78,16 @@ typedef struct
 	ralf_params_lora_t 	loraParam_tx;
 	radio_modes_e		lastMode;
 	ralf_t				ralf;
+	uint8_t				cfgDirty;		// RU_CFG_DIRTY_* - loraParam_tx/rx je treba znovu nacist z NVM
+	uint8_t				appliedValid;	// RU_APPLIED_* - ktere casti loraApplied odpovidaji SX126x
+	ralf_params_lora_t	loraApplied;	// parametry, ktere jsou prave nastaveny v SX126x
+	bool				rxSniff;		// RX duty-cycle misto continuous RX (nacita se s RX konfiguraci)
+	uint32_t			sniffRxMs;
+	uint32_t			sniffSleepMs;
+	uint8_t				modem;			// RF_MODEM_LORA / RF_MODEM_GFSK (nacita se s RU_CFG_DIRTY_MODEM)
+	ralf_params_gfsk_t	gfskParam;		// frekvence a vykon se doplni z loraParam_tx/rx
+	uint8_t				gfskSync[NVMA_GFSK_MAX_SYNC_LEN];
+	uint32_t			gfskAppliedFreq;
 
 }radioConfig_t;
 
@@ -90,6 +102,25 @@ typedef struct
 
 
 
+/*
+ * TX FIFO - dalsi paket se spousti primo z TX done IRQ
+ */
+typedef struct
+{
+	struct packet_info_s	*pkt[RF_TX_FIFO_SIZE];
+	uint8_t					head;		// prave vysilany paket
+	uint8_t					count;
+	uint32_t				toaMs;		// TOA paketu na head
+	uint32_t				doneUs;		// cas TX done IRQ paketu na head [us]
+	uint8_t					lbtAttempt;	// neuspesne CAD pro paket na head
+	bool					lbtCad;		// bezi CAD pro LBT
+	bool					lbtWaiting;	// ceka se na konec backoffu
+	bool					lrFhss;		// head se vysila LR-FHSS - DIO1 hlasi i hopy
+	bool					schedWaiting;	// head ceka na preload pred slotem, mezitim RX
+	bool					schedArmed;	// head ceka v standby na TIM2 compare
+
+}rfTxFifo_t;
+
 typedef enum
 {
 	RF_TASK_OFF = 0,
@@ -114,6 +145,7 @@ typedef struct
 	TimerResource_t	rfHBTimer;	// pokud SX1262 nevykona delsi dobu zadnou akci,
 								// tak ho znovu aktivujeme
 	TimerResource_t rfEventLedTimer; // LED indikace udalosti (RX/TX)
+	TimerResource_t rfLbtTimer;		// LBT backoff pred dalsim CAD
 
 
 }RFTimers_t;
@@ -123,6 +155,7 @@ typedef struct
 	radioConfig_t		rfConfig;
 	radio_states_t		rfTaskState;
 	RFTimers_t			timers;
+	rfTxFifo_t			txFifo;
 	bool				rx_to_uart;		//true, false
 
 } radio_context_t;